@@ -56,6 +56,12 @@ sub test($$$$$) {
   my $output = $input;
   $output =~ s/\.(o|c|gb|xml)$/.out/;
 
+  # further tests in the same directory get their own output
+  if($test ne "test.desc") {
+    $output = $test;
+    $output =~ s/\.desc$/.out/;
+  }
+
   if($output eq $input) {
     print("Error in test file -- $test\n");
     return 1;
@@ -118,6 +124,18 @@ sub test($$$$$) {
   return $failed;
 }
 
+sub descs() {
+  my @list;
+
+  opendir CWD, ".";
+  @list = grep { /\.desc$/ && $_ ne "test.desc" && -s "$_" } readdir CWD;
+  closedir CWD;
+
+  @list = sort @list;
+
+  return ("test.desc", @list);
+}
+
 sub dirs() {
   my @list;
 
@@ -157,6 +175,8 @@ Usage: test.pl -c CMD [OPTIONS] [DIRECTORIES ...]
 
 test.pl expects a test.desc file in each subdirectory. The file test.desc
 follows the format specified below. Any line starting with // will be ignored.
+Further *.desc files in the same subdirectory are run after test.desc, in
+alphabetical order, and may rely on what the earlier ones have left behind.
 
 <level>
 <main source>
@@ -210,7 +230,12 @@ foreach my $test (@tests) {
 
   my $cwd = getcwd;
   chdir $test;
-  my $failed_skipped = test($test, "test.desc", $t_level, $opt_c, $opt_i);
+  my $failed_skipped = -1;
+  foreach my $desc (descs()) {
+    my $name = $desc eq "test.desc" ? $test : "$test/$desc";
+    my $result = test($name, $desc, $t_level, $opt_c, $opt_i);
+    $failed_skipped = $result if($result > $failed_skipped);
+  }
   chdir $cwd;
 
   if($failed_skipped < 0) {
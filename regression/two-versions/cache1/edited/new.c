@@ -0,0 +1,10 @@
+int glob;
+
+void my_f(int parameter)
+{
+  if(parameter>=0) // only a comment is new
+  {
+    assert(parameter==1);
+    assert(glob==2);
+  }
+}
@@ -0,0 +1,7 @@
+int glob;
+
+void my_f(int parameter)
+{
+  assert(parameter==1);
+  assert(glob==2);
+}
@@ -0,0 +1,25 @@
+int glob;
+
+void my_f(int parameter)
+{
+  if(parameter>=0)
+  {
+    assert(parameter==1);
+    assert(glob==2);
+  }
+}
+
+void my_g(int parameter)
+{
+  if(parameter>=0)
+  {
+    assert(parameter==1);
+    assert(glob==2);
+  }
+}
+
+void my_h(int parameter)
+{
+  // should fail, stronger!
+  assert(parameter==100);
+}
@@ -0,0 +1,21 @@
+int glob;
+
+void my_f(int parameter)
+{
+  assert(parameter==1);
+  assert(glob==2);
+}
+
+void my_g(int parameter)
+{
+  assert(parameter==1);
+  assert(glob==2);
+}
+
+void my_h(int parameter)
+{
+  int bound;
+  
+  if(bound<10)
+    assert(parameter==100);
+}
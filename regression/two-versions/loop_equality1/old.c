@@ -0,0 +1,11 @@
+int glob;
+
+void my_f(int x, int n)
+{
+  int i;
+
+  for(i=0; i<n; i++)
+    x=x+i;
+
+  assert(x!=42);
+}
@@ -0,0 +1,14 @@
+int glob;
+
+void my_f(int x, int n)
+{
+  int i, j;
+
+  for(j=0; j<n; j++)
+    glob++;
+
+  for(i=0; i<n; i++)
+    x=x+i;
+
+  assert(x!=42);
+}
@@ -0,0 +1,9 @@
+int glob;
+
+void my_f(int i)
+{
+  int a[10];
+
+  a[i]=1;
+  glob=1;
+}
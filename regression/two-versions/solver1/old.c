@@ -0,0 +1,8 @@
+int glob;
+
+void my_f(int i)
+{
+  int a[10];
+
+  a[i]=1;
+}
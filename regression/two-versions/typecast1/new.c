@@ -0,0 +1,11 @@
+void my_f(int v)
+{
+  unsigned char c;
+  short s;
+
+  c=(unsigned char)v;
+  s=(short)v;
+
+  // fails for v==256
+  assert((int)c==(int)s);
+}
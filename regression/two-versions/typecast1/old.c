@@ -0,0 +1,8 @@
+void my_f(int v)
+{
+  unsigned char c;
+  short s;
+
+  c=(unsigned char)v;
+  s=(short)v;
+}
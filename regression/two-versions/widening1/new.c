@@ -0,0 +1,9 @@
+int glob;
+
+void my_f(int n)
+{
+  int i;
+
+  for(i=0; i<n; i++)
+    glob=i;
+}
@@ -0,0 +1,6 @@
+int glob;
+
+void my_f(int n)
+{
+  glob=n;
+}
@@ -6,7 +6,17 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
+#include <sstream>
 
 #include <util/message.h>
 #include <util/time_stopping.h>
@@ -22,8 +32,12 @@ Author: Daniel Kroening, kroening@kroening.com
 #include "ssa_fixed_point.h"
 #include "statistics.h"
 #include "report_source_code.h"
+#include "get_source.h"
 #include "analyzer.h"
 #include "change_impact.h"
+#include "function_cache.h"
+
+#include "../ssa/module_value_set.h"
 
 class deltacheck_analyzert:public messaget
 {
@@ -40,7 +54,11 @@ public:
     path_new(_path_new),
     goto_model_old(_goto_model_old),
     goto_model_new(_goto_model_new),
-    options(_options)
+    options(_options),
+    ns_old(_goto_model_old.symbol_table),
+    ns_new(_goto_model_new.symbol_table),
+    module_value_set_old(ns_old),
+    module_value_set_new(ns_new)
   {
   }
   
@@ -56,19 +74,77 @@ protected:
   const optionst &options;
   
   change_impactt change_impact;
+
+  // the values of the global variables and the parameters,
+  // once per goto model; the SSA of the functions starts
+  // from these
+  const namespacet ns_old, ns_new;
+  module_value_sett module_value_set_old, module_value_set_new;
+
+  void module_value_set_analysis(
+    const std::string &binary,
+    const goto_modelt &,
+    module_value_sett &);
+  
+  // What we get for a function. This is what
+  // worker processes pass back to us.
+  struct function_resultt
+  {
+    statisticst statistics;
+    
+    // one of P(assed), F(ailed), U(nknown) per property
+    std::string property_status;
+
+    void write(std::ostream &) const;
+    bool read(std::istream &);
+  };
   
   void check_function(
     const irep_idt &,
+    function_resultt &,
     std::ostream &global_report);
 
   void check_all(std::ostream &global_report);
+
+  typedef std::vector<irep_idt> function_listt;
+  typedef std::vector<function_resultt> resultst;
+
+  void report_functions(
+    const function_listt &,
+    const resultst &,
+    std::ostream &global_report);
+
+  // runs the functions in separate worker processes
+  struct workert
+  {
+    pid_t pid;
+    int task_fd, result_fd;
+    bool busy;
+    unsigned function_nr;
+    std::string buffer;
+  };
+  
+  void check_parallel(
+    const function_listt &,
+    unsigned jobs,
+    resultst &,
+    std::ostream &global_report);
+
+  void run_worker(
+    const function_listt &,
+    int task_fd, int result_fd,
+    std::ostream &global_report);
+  
+  unsigned next_task;
+  void send_task(workert &, const function_listt &);
   
   unsigned errors_in_file, passed_in_file,
            unknown_in_file, unaffected_in_file,
            LOCs_in_file;
   
-  void collect_statistics(const propertiest &);
-  void collect_statistics(const goto_functionst::goto_functiont &);
+  void collect_statistics(const propertiest &, statisticst &);
+  void collect_statistics(const std::string &property_status, statisticst &);
+  void collect_statistics(const goto_functionst::goto_functiont &, statisticst &);
 };
 
 /*******************************************************************\
@@ -85,8 +161,11 @@ Function: deltacheck_analyzert::check_function
 
 void deltacheck_analyzert::check_function(
   const irep_idt &function,
+  function_resultt &function_result,
   std::ostream &global_report)
 {
+  statisticst &statistics=function_result.statistics;
+
   const goto_functionst::function_mapt::const_iterator
     fmap_it_new=goto_model_new.goto_functions.function_map.find(function);
       
@@ -102,7 +181,7 @@ void deltacheck_analyzert::check_function(
 
   // update statistics
   LOCs_in_file+=fkt_new.body.instructions.size();
-  collect_statistics(fkt_new);
+  collect_statistics(fkt_new, statistics);
   statistics.number_map["Functions"]++;      
 
   // Is this function at all affected?
@@ -122,9 +201,6 @@ void deltacheck_analyzert::check_function(
     
   status() << "Checking \"" << function << "\"" << eom;
   
-  const namespacet ns_new(goto_model_new.symbol_table);
-  const namespacet ns_old(goto_model_old.symbol_table);
-    
   const symbolt &symbol_new=ns_new.lookup(function);
   
   // get corresponding goto_model_old function, if available
@@ -143,20 +219,82 @@ void deltacheck_analyzert::check_function(
     fmap_it_old==goto_model_old.goto_functions.function_map.end()?symbol_old_dummy:
     ns_old.lookup(function);
     
-  // set up report
-
   std::string report_file_name=
     make_relative_path(path_new, "deltacheck."+id2string(function)+".html");
-    
-  std::ofstream function_report(report_file_name.c_str());
+
+  // have we seen the very same pair of functions before?
+  std::string cache_directory=options.get_option("cache");
+  std::string cache_key;
+
+  if(!cache_directory.empty())
+  {
+    // the analysis depends on the values of the globals
+    std::ostringstream context;
+    module_value_set_old.output_seed(fkt_old, context);
+    context << "--\n";
+    module_value_set_new.output_seed(fkt_new, context);
+
+    // The report lists the source code, which may change
+    // where the goto program doesn't, say, in a comment.
+    // The report gives the errors, if any.
+    null_message_handlert null_message_handler;
+    std::list<linet> lines_old, lines_new;
+    get_source(path_old, symbol_old.location, fkt_old.body,
+               lines_old, null_message_handler);
+    get_source(path_new, symbol_new.location, fkt_new.body,
+               lines_new, null_message_handler);
+
+    context << "--\n";
+    for(std::list<linet>::const_iterator
+        l_it=lines_old.begin(); l_it!=lines_old.end(); l_it++)
+      context << l_it->line << "\n";
+
+    context << "--\n";
+    for(std::list<linet>::const_iterator
+        l_it=lines_new.begin(); l_it!=lines_new.end(); l_it++)
+      context << l_it->line << "\n";
+
+    cache_key=function_cachet::key(
+      function, fkt_old, ns_old, fkt_new, ns_new, options, context.str());
+
+    function_cachet::entryt entry;
+
+    if(function_cachet(cache_directory).lookup(cache_key, entry))
+    {
+      status() << "Using cached result for \"" << function << "\"" << eom;
+      statistics.number_map["Cache-hits"]++;
+
+      std::ofstream cached_report(report_file_name.c_str());
+      cached_report << entry.report;
+
+      // the same lines as report_properties gives
+      for(unsigned p=0; p<entry.property_status.size(); p++)
+      {
+        char status=entry.property_status[p];
+        report_property(
+          entry.property_ids[p], entry.property_comments[p],
+          status=='P'?tvt(true):status=='F'?tvt(false):tvt::unknown(),
+          *this);
+      }
+
+      function_result.property_status=entry.property_status;
+      collect_statistics(entry.property_status, statistics);
+      return;
+    }
+
+    statistics.number_map["Cache-misses"]++;
+  }
+
+  // set up report; we keep it in memory, for the cache
+  std::ostringstream function_report;
   
   html_report_header("Function "+id2string(symbol_new.display_name()), function_report);
 
   // build SSA for each
   status() << "Building SSA" << eom;
   statistics.start("SSA");
-  local_SSAt SSA_old(fkt_old, ns_old, "@old");
-  local_SSAt SSA_new(fkt_new, ns_new);
+  local_SSAt SSA_old(fkt_old, ns_old, "@old", &module_value_set_old);
+  local_SSAt SSA_new(fkt_new, ns_new, "", &module_value_set_new);
   statistics.stop("SSA");
 
   // add assertions in old version as assumptions
@@ -168,8 +306,59 @@ void deltacheck_analyzert::check_function(
     ns_old.get_symbol_table());
   status() << "Joint data-flow fixed-point" << eom;
   statistics.start("Fixed-point");
-  ssa_fixed_pointt ssa_fixed_point(SSA_old, SSA_new, joint_ns);
+  function_cachet invariant_cache(cache_directory);
+  ssa_fixed_pointt ssa_fixed_point(
+    SSA_old, SSA_new, joint_ns, function,
+    cache_directory.empty()?NULL:&invariant_cache,
+    options.get_int_option("widening-delay"));
   statistics.stop("Fixed-point");
+  statistics.number_map["Solver-proved"]+=ssa_fixed_point.solver_proved;
+  statistics.number_map["SAT-checked"]+=ssa_fixed_point.sat_checked;
+  statistics.number_map["Constraints"]+=ssa_fixed_point.constraints_total;
+  statistics.number_map["Constraints-sliced"]+=
+    ssa_fixed_point.constraints_sliced;
+
+  for(ssa_fixed_pointt::loopst::const_iterator
+      l_it=ssa_fixed_point.loops.begin();
+      l_it!=ssa_fixed_point.loops.end();
+      l_it++)
+  {
+    // a paired old and new loop have one fixed point
+    statistics.number_map["Loops"]+=l_it->with_old?2:1;
+    statistics.number_map["Fixed-point-iterations"]+=l_it->iterations;
+  }
+
+  statistics.number_map["Invariants-reused"]+=
+    ssa_fixed_point.invariants_reused;
+  statistics.number_map["Invariants-rejected"]+=
+    ssa_fixed_point.invariants_rejected;
+  statistics.number_map["Iterations-saved"]+=
+    ssa_fixed_point.iterations_saved;
+  statistics.number_map["Houdini-candidates"]+=
+    ssa_fixed_point.houdini_candidates;
+  statistics.number_map["Houdini-invariants"]+=
+    ssa_fixed_point.houdini_invariants;
+  statistics.number_map["Houdini-rounds"]+=
+    ssa_fixed_point.houdini_rounds;
+  statistics.number_map["Induction-variables"]+=
+    ssa_fixed_point.induction_variables;
+  statistics.number_map["Induction-candidates"]+=
+    ssa_fixed_point.induction_candidates;
+  statistics.number_map["Induction-bounds"]+=
+    ssa_fixed_point.induction_invariants;
+  statistics.number_map["Induction-iterations-saved"]+=
+    ssa_fixed_point.induction_iterations_saved;
+  statistics.number_map["Widenings"]+=
+    ssa_fixed_point.widenings;
+
+  statistics.number_map["SSA-names-built"]+=
+    SSA_old.names_built+SSA_new.names_built;
+  statistics.number_map["SSA-name-cache-hits"]+=
+    SSA_old.name_cache_hits+SSA_new.name_cache_hits;
+  statistics.number_map["Alias-queries"]+=
+    SSA_old.alias_oracle.queries+SSA_new.alias_oracle.queries;
+  statistics.number_map["Alias-cache-hits"]+=
+    SSA_old.alias_oracle.hits+SSA_new.alias_oracle.hits;
   
   // now report on assertions
   std::string description_old=
@@ -191,15 +380,45 @@ void deltacheck_analyzert::check_function(
     function_report, get_message_handler());
   statistics.stop("Reporting");
   
-  // dump statistics
+  // dump statistics, including the ones for each loop
   statistics.html_report_last(function_report);
+  ssa_fixed_point.statistics.html_report_total(function_report);
 
   // collect some more data
-  #if 0
-  collect_statistics(ssa_fixed_point.properties); 
-  #endif
+  collect_statistics(ssa_fixed_point.properties, statistics);
+
+  for(propertiest::const_iterator
+      p_it=ssa_fixed_point.properties.begin();
+      p_it!=ssa_fixed_point.properties.end();
+      p_it++)
+    function_result.property_status+=
+      p_it->status.is_true()?'P':p_it->status.is_false()?'F':'U';
 
   function_report << "</body></html>\n";
+
+  std::ofstream function_report_file(report_file_name.c_str());
+  function_report_file << function_report.str();
+
+  if(!cache_directory.empty())
+  {
+    function_cachet::entryt entry;
+    entry.property_status=function_result.property_status;
+    entry.report=function_report.str();
+
+    for(propertiest::const_iterator
+        p_it=ssa_fixed_point.properties.begin();
+        p_it!=ssa_fixed_point.properties.end();
+        p_it++)
+    {
+      const source_locationt &location=p_it->loc->source_location;
+      entry.property_ids.push_back(id2string(location.get_property_id()));
+      entry.property_comments.push_back(id2string(location.get_comment()));
+    }
+
+    if(function_cachet(cache_directory).store(cache_key, entry))
+      warning() << "failed to write cache entry for \""
+                << function << "\"" << eom;
+  }
   
   #if 0
   global_report << "<table class=\"file-table\">\n"
@@ -238,13 +457,456 @@ Function: deltacheck_analyzert::check_all
 void deltacheck_analyzert::check_all(std::ostream &global_report)
 {
   // we do this by function in the new goto_model
+  function_listt functions;
+
   for(goto_functionst::function_mapt::const_iterator
       fmap_it=goto_model_new.goto_functions.function_map.begin();
       fmap_it!=goto_model_new.goto_functions.function_map.end();
       fmap_it++)
+    functions.push_back(fmap_it->first);
+
+  // We keep the results per function, and merge them in the
+  // order of the function map, whatever order the analyses
+  // complete in.
+  resultst results(functions.size());
+
+  int jobs=options.get_int_option("jobs");
+
+  if(jobs<=1 || functions.size()<=1)
   {
-    check_function(fmap_it->first, global_report);
+    for(unsigned i=0; i<functions.size(); i++)
+      check_function(functions[i], results[i], global_report);
   }
+  else
+    check_parallel(functions, jobs, results, global_report);
+
+  for(unsigned i=0; i<results.size(); i++)
+    statistics.merge(results[i].statistics);
+
+  report_functions(functions, results, global_report);
+}
+
+/*******************************************************************\
+
+Function: deltacheck_analyzert::report_functions
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: table of the functions that have been checked
+
+\*******************************************************************/
+
+void deltacheck_analyzert::report_functions(
+  const function_listt &functions,
+  const resultst &results,
+  std::ostream &global_report)
+{
+  global_report << "<h2>Functions</h2>\n";
+
+  global_report << "<table class=\"file-table\">\n"
+                << "<tr><th>Function</th>"
+                << "<th># Passed</th>"
+                << "<th># Errors</th>"
+                << "<th># Unknown</th>"
+                << "</tr>\n";
+
+  for(unsigned i=0; i<functions.size(); i++)
+  {
+    const std::string &status=results[i].property_status;
+    if(status.empty()) continue;
+
+    unsigned passed=0, errors=0, unknown=0;
+
+    for(unsigned p=0; p<status.size(); p++)
+      if(status[p]=='P')
+        passed++;
+      else if(status[p]=='F')
+        errors++;
+      else
+        unknown++;
+
+    std::string report_url=
+      "deltacheck."+id2string(functions[i])+".html";
+
+    global_report << "<tr><td><a href=\"" << html_escape(report_url)
+                  << "\">" << html_escape(id2string(functions[i]))
+                  << "</a></td>"
+                  << "<td align=\"right\">" << passed << "</td>"
+                  << "<td align=\"right\">" << errors << "</td>"
+                  << "<td align=\"right\">" << unknown << "</td>"
+                  << "</tr>\n";
+  }
+
+  global_report << "</table>\n\n";
+}
+
+/*******************************************************************\
+
+Function: deltacheck_analyzert::function_resultt::write
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void deltacheck_analyzert::function_resultt::write(std::ostream &out) const
+{
+  out << "S " << property_status << "\n";
+  statistics.write(out);
+}
+
+/*******************************************************************\
+
+Function: deltacheck_analyzert::function_resultt::read
+
+  Inputs:
+
+ Outputs: true on error
+
+ Purpose:
+
+\*******************************************************************/
+
+bool deltacheck_analyzert::function_resultt::read(std::istream &in)
+{
+  std::string line;
+
+  if(!std::getline(in, line) ||
+     line.size()<2 || line[0]!='S')
+    return true;
+
+  property_status=line.substr(2);
+
+  return statistics.read(in);
+}
+
+/*******************************************************************\
+
+Function: write_all
+
+  Inputs:
+
+ Outputs: true on error
+
+ Purpose:
+
+\*******************************************************************/
+
+static bool write_all(int fd, const std::string &data)
+{
+  std::size_t done=0;
+
+  while(done<data.size())
+  {
+    ssize_t result=write(fd, data.data()+done, data.size()-done);
+
+    if(result<0)
+    {
+      if(errno==EINTR) continue;
+      return true;
+    }
+
+    done+=result;
+  }
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: deltacheck_analyzert::check_parallel
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: CBMC's ireps use non-atomic reference counts, and thus,
+          the goto models cannot be shared among threads. We fork
+          worker processes instead, which inherit the goto models
+          we have read copy-on-write. Each worker gets the numbers
+          of the functions to analyse through a pipe, one at a time
+          whenever it becomes idle, and streams back a result record
+          per function through another pipe. The functions of a
+          worker that dies are done again here.
+
+\*******************************************************************/
+
+void deltacheck_analyzert::check_parallel(
+  const function_listt &functions,
+  unsigned jobs,
+  resultst &results,
+  std::ostream &global_report)
+{
+  status() << "Using " << jobs << " worker processes" << eom;
+
+  std::vector<workert> workers;
+
+  // the functions of workers that have died on them
+  std::vector<unsigned> failed;
+
+  // Don't give buffered output to the workers.
+  std::cout << std::flush;
+
+  // A worker that has died closes its end of the task pipe;
+  // we want to see EPIPE then instead of getting killed.
+  void (*old_sigpipe)(int)=signal(SIGPIPE, SIG_IGN);
+
+  for(unsigned w=0; w<jobs; w++)
+  {
+    int task_pipe[2], result_pipe[2];
+
+    if(pipe(task_pipe)!=0)
+    {
+      error() << "failed to create pipe for worker process" << eom;
+      break;
+    }
+
+    if(pipe(result_pipe)!=0)
+    {
+      error() << "failed to create pipe for worker process" << eom;
+      close(task_pipe[0]);
+      close(task_pipe[1]);
+      break;
+    }
+
+    pid_t pid=fork();
+
+    if(pid==-1)
+    {
+      error() << "failed to start worker process" << eom;
+      close(task_pipe[0]);
+      close(task_pipe[1]);
+      close(result_pipe[0]);
+      close(result_pipe[1]);
+      break;
+    }
+    else if(pid==0)
+    {
+      // We are the worker. We close our copies of the ends
+      // that belong to the parent, or the other workers won't
+      // see the end of their task pipes.
+      close(task_pipe[1]);
+      close(result_pipe[0]);
+
+      for(unsigned w2=0; w2<workers.size(); w2++)
+      {
+        close(workers[w2].task_fd);
+        close(workers[w2].result_fd);
+      }
+
+      run_worker(functions, task_pipe[0], result_pipe[1], global_report);
+    }
+
+    close(task_pipe[0]);
+    close(result_pipe[1]);
+
+    workert worker;
+    worker.pid=pid;
+    worker.task_fd=task_pipe[1];
+    worker.result_fd=result_pipe[0];
+    worker.busy=false;
+    worker.function_nr=0;
+    workers.push_back(worker);
+  }
+
+  next_task=0;
+
+  for(unsigned w=0; w<workers.size(); w++)
+    send_task(workers[w], functions);
+
+  // collect the result records as they arrive
+  while(true)
+  {
+    std::vector<pollfd> poll_fds;
+    std::vector<unsigned> poll_workers;
+
+    for(unsigned w=0; w<workers.size(); w++)
+      if(workers[w].result_fd!=-1)
+      {
+        pollfd p;
+        p.fd=workers[w].result_fd;
+        p.events=POLLIN;
+        p.revents=0;
+        poll_fds.push_back(p);
+        poll_workers.push_back(w);
+      }
+
+    if(poll_fds.empty()) break; // all done
+
+    if(poll(&poll_fds.front(), poll_fds.size(), -1)<0)
+    {
+      if(errno==EINTR) continue;
+      error() << "failed to wait for worker processes" << eom;
+      break;
+    }
+
+    for(unsigned i=0; i<poll_fds.size(); i++)
+    {
+      if(poll_fds[i].revents==0) continue;
+
+      workert &worker=workers[poll_workers[i]];
+      char buffer[4096];
+      ssize_t count=read(worker.result_fd, buffer, sizeof(buffer));
+
+      if(count<0 && errno==EINTR)
+        continue;
+
+      if(count<=0)
+      {
+        // the worker is gone
+        close(worker.result_fd);
+        worker.result_fd=-1;
+
+        if(worker.task_fd!=-1)
+        {
+          close(worker.task_fd);
+          worker.task_fd=-1;
+        }
+
+        if(worker.busy)
+        {
+          error() << "worker process failed on function `"
+                  << functions[worker.function_nr] << "'" << eom;
+          failed.push_back(worker.function_nr);
+          worker.busy=false;
+        }
+
+        continue;
+      }
+
+      worker.buffer.append(buffer, count);
+
+      // a record ends with a line "E"
+      std::size_t end;
+      while((end=worker.buffer.find("\nE\n"))!=std::string::npos)
+      {
+        std::istringstream record(worker.buffer.substr(0, end+3));
+        worker.buffer.erase(0, end+3);
+
+        std::string line;
+        std::getline(record, line);
+        unsigned nr=strtoul(line.c_str(), NULL, 10);
+
+        if(nr>=functions.size() || results[nr].read(record))
+          error() << "bad result record from worker process" << eom;
+
+        worker.busy=false;
+        send_task(worker, functions);
+      }
+    }
+  }
+
+  for(unsigned w=0; w<workers.size(); w++)
+  {
+    int worker_status;
+
+    if(waitpid(workers[w].pid, &worker_status, 0)==-1 ||
+       !WIFEXITED(worker_status) ||
+       WEXITSTATUS(worker_status)!=0)
+      error() << "worker process " << w << " has failed" << eom;
+  }
+
+  signal(SIGPIPE, old_sigpipe);
+
+  // do again what the workers have died on; the partial
+  // result record, if any, has been dropped
+  for(unsigned i=0; i<failed.size(); i++)
+  {
+    unsigned nr=failed[i];
+    status() << "Checking function `" << functions[nr]
+             << "' again" << eom;
+    results[nr]=function_resultt();
+    check_function(functions[nr], results[nr], global_report);
+  }
+
+  // do what no worker got to do
+  for(; next_task<functions.size(); next_task++)
+    check_function(functions[next_task], results[next_task], global_report);
+}
+
+/*******************************************************************\
+
+Function: deltacheck_analyzert::send_task
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: give the next function to an idle worker,
+          or tell it that there is nothing left to do;
+          if the worker is gone, the function stays for
+          the next one
+
+\*******************************************************************/
+
+void deltacheck_analyzert::send_task(
+  workert &worker,
+  const function_listt &functions)
+{
+  if(worker.task_fd==-1) return;
+
+  if(next_task<functions.size())
+  {
+    std::ostringstream task;
+    task << next_task << "\n";
+
+    if(!write_all(worker.task_fd, task.str()))
+    {
+      worker.busy=true;
+      worker.function_nr=next_task;
+      next_task++;
+      return;
+    }
+  }
+
+  close(worker.task_fd);
+  worker.task_fd=-1;
+}
+
+/*******************************************************************\
+
+Function: deltacheck_analyzert::run_worker
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the main loop of a worker process; doesn't return
+
+\*******************************************************************/
+
+void deltacheck_analyzert::run_worker(
+  const function_listt &functions,
+  int task_fd, int result_fd,
+  std::ostream &global_report)
+{
+  FILE *tasks=fdopen(task_fd, "r");
+  unsigned nr;
+
+  while(tasks!=NULL &&
+        fscanf(tasks, "%u", &nr)==1 &&
+        nr<functions.size())
+  {
+    function_resultt function_result;
+    check_function(functions[nr], function_result, global_report);
+
+    std::ostringstream record;
+    record << nr << "\n";
+    function_result.write(record);
+
+    std::cout << std::flush;
+
+    if(write_all(result_fd, record.str()))
+      break;
+  }
+
+  std::cout << std::flush;
+  _exit(0);
 }
 
 /*******************************************************************\
@@ -260,7 +922,8 @@ Function: deltacheck_analyzert::collect_statistics
 \*******************************************************************/
 
 void deltacheck_analyzert::collect_statistics(
-  const goto_functionst::goto_functiont &goto_function)
+  const goto_functionst::goto_functiont &goto_function,
+  statisticst &statistics)
 {
   statistics.number_map["LOCs"]+=goto_function.body.instructions.size();
 }
@@ -278,7 +941,8 @@ Function: deltacheck_analyzert::collect_statistics
 \*******************************************************************/
 
 void deltacheck_analyzert::collect_statistics(
-  const propertiest &properties)
+  const propertiest &properties,
+  statisticst &statistics)
 {
   for(propertiest::const_iterator
       p_it=properties.begin();
@@ -305,6 +969,82 @@ void deltacheck_analyzert::collect_statistics(
 
 /*******************************************************************\
 
+Function: deltacheck_analyzert::collect_statistics
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: same as above, for a result from the cache
+
+\*******************************************************************/
+
+void deltacheck_analyzert::collect_statistics(
+  const std::string &property_status,
+  statisticst &statistics)
+{
+  for(unsigned p=0; p<property_status.size(); p++)
+  {
+    if(property_status[p]=='F')
+    {
+      errors_in_file++;
+      statistics.number_map["Errors"]++;
+    }
+    else if(property_status[p]=='P')
+    {
+      passed_in_file++;
+      statistics.number_map["Passed"]++;
+    }
+    else
+    {
+      unknown_in_file++;
+      statistics.number_map["Unknown"]++;
+    }
+  }
+}
+
+/*******************************************************************\
+
+Function: deltacheck_analyzert::module_value_set_analysis
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: With a cache, the result is kept next to the goto
+          binary, and thus, the runs on two adjacent revisions
+          share the analysis of the binary they have in common.
+
+\*******************************************************************/
+
+void deltacheck_analyzert::module_value_set_analysis(
+  const std::string &binary,
+  const goto_modelt &goto_model,
+  module_value_sett &module_value_set)
+{
+  std::string file_name, key;
+
+  if(!options.get_option("cache").empty() && !binary.empty())
+  {
+    file_name=binary+".deltacheck-values";
+    key=function_cachet::file_key(binary);
+
+    if(!key.empty() && !module_value_set.read(file_name, key))
+    {
+      status() << "Read value sets of \"" << binary << "\"" << eom;
+      return;
+    }
+  }
+
+  status() << "Value set analysis of \"" << binary << "\"" << eom;
+  module_value_set(goto_model.goto_functions);
+
+  if(!key.empty() && module_value_set.write(file_name, key))
+    warning() << "failed to write \"" << file_name << "\"" << eom;
+}
+
+/*******************************************************************\
+
 Function: deltacheck_analyzert::operator()
 
   Inputs:
@@ -347,10 +1087,22 @@ void deltacheck_analyzert::operator()()
   change_impact.change_impact(goto_model_new);
   statistics.stop("Change-impact");
 
+  // Before forking, and thus, the workers share these.
+  statistics.start("Module-value-sets");
+  module_value_set_analysis(
+    options.get_option("binary-old"), goto_model_old, module_value_set_old);
+  module_value_set_analysis(
+    options.get_option("binary-new"), goto_model_new, module_value_set_new);
+  statistics.stop("Module-value-sets");
+
   status() << "Starting analysis" << eom;
 
   if(options.get_option("function")!="")
-    check_function(options.get_option("function"), out);
+  {
+    function_resultt function_result;
+    check_function(options.get_option("function"), function_result, out);
+    statistics.merge(function_result.statistics);
+  }
   else
     check_all(out);
 
@@ -368,6 +1120,24 @@ void deltacheck_analyzert::operator()()
 
   messaget::statistics() << "LOCs analyzed: " << statistics.number_map["LOCs"] << eom;
   messaget::statistics() << "Functions analyzed: " << statistics.number_map["Functions"] << eom;
+  messaget::statistics() << "Properties proved by solver: " << statistics.number_map["Solver-proved"] << eom;
+  messaget::statistics() << "Properties checked by SAT: " << statistics.number_map["SAT-checked"] << eom;
+  messaget::statistics() << "Constraints after slicing: " << statistics.number_map["Constraints-sliced"]
+                         << " of " << statistics.number_map["Constraints"] << eom;
+  messaget::statistics() << "Loop invariants reused: " << statistics.number_map["Invariants-reused"]
+                         << " of " << statistics.number_map["Loops"]
+                         << ", rejected: " << statistics.number_map["Invariants-rejected"]
+                         << ", iterations saved: " << statistics.number_map["Iterations-saved"] << eom;
+  messaget::statistics() << "Old/new loop equalities: " << statistics.number_map["Houdini-invariants"]
+                         << " of " << statistics.number_map["Houdini-candidates"]
+                         << " in " << statistics.number_map["Houdini-rounds"] << " round(s)" << eom;
+  messaget::statistics() << "Induction variables: " << statistics.number_map["Induction-variables"]
+                         << ", bounds: " << statistics.number_map["Induction-bounds"]
+                         << " of " << statistics.number_map["Induction-candidates"]
+                         << ", iterations saved: " << statistics.number_map["Induction-iterations-saved"] << eom;
+  messaget::statistics() << "Loops widened: " << statistics.number_map["Widenings"]
+                         << " of " << statistics.number_map["Loops"]
+                         << ", fixed-point iterations: " << statistics.number_map["Fixed-point-iterations"] << eom;
   
   memory_info(messaget::statistics());
   messaget::statistics() << eom;
@@ -388,6 +1158,29 @@ void deltacheck_analyzert::operator()()
   json_out << "    \"failed\": " << statistics.number_map["Errors"] << ",\n";
   json_out << "    \"warned\": " << statistics.number_map["Unknown"] << "\n";
   json_out << "  },\n";
+  json_out << "  \"cache\": {\n";
+  json_out << "    \"hits\": " << statistics.number_map["Cache-hits"] << ",\n";
+  json_out << "    \"misses\": " << statistics.number_map["Cache-misses"] << "\n";
+  json_out << "  },\n";
+  json_out << "  \"decision_procedures\": {\n";
+  json_out << "    \"solver_proved\": " << statistics.number_map["Solver-proved"] << ",\n";
+  json_out << "    \"SAT_checked\": " << statistics.number_map["SAT-checked"] << "\n";
+  json_out << "  },\n";
+  json_out << "  \"slicing\": {\n";
+  json_out << "    \"constraints\": " << statistics.number_map["Constraints"] << ",\n";
+  json_out << "    \"sliced\": " << statistics.number_map["Constraints-sliced"] << "\n";
+  json_out << "  },\n";
+  json_out << "  \"invariants\": {\n";
+  json_out << "    \"loops\": " << statistics.number_map["Loops"] << ",\n";
+  json_out << "    \"reused\": " << statistics.number_map["Invariants-reused"] << ",\n";
+  json_out << "    \"rejected\": " << statistics.number_map["Invariants-rejected"] << ",\n";
+  json_out << "    \"iterations\": " << statistics.number_map["Fixed-point-iterations"] << ",\n";
+  json_out << "    \"iterations_saved\": " << statistics.number_map["Iterations-saved"] << ",\n";
+  json_out << "    \"induction_variables\": " << statistics.number_map["Induction-variables"] << ",\n";
+  json_out << "    \"induction_bounds\": " << statistics.number_map["Induction-bounds"] << ",\n";
+  json_out << "    \"induction_iterations_saved\": " << statistics.number_map["Induction-iterations-saved"] << ",\n";
+  json_out << "    \"widenings\": " << statistics.number_map["Widenings"] << "\n";
+  json_out << "  },\n";
   json_out << "  \"program\": {\n";
   json_out << "    \"LOCs\": " << statistics.number_map["LOCs"] << ",\n";
   json_out << "    \"functions\": " << statistics.number_map["Functions"] << "\n";
@@ -206,6 +206,17 @@ int deltacheck_parse_optionst::doit()
     if(cmdline.isset("function"))
       options.set_option("function", cmdline.get_value("function"));
     
+    if(cmdline.isset("jobs"))
+      options.set_option("jobs", cmdline.get_value("jobs"));
+    
+    if(cmdline.isset("cache"))
+      options.set_option("cache", cmdline.get_value("cache"));
+    
+    if(cmdline.isset("widening-delay"))
+      options.set_option("widening-delay", cmdline.get_value("widening-delay"));
+    else
+      options.set_option("widening-delay", 10);
+    
     if(cmdline.args.size()!=2)
     {
       usage_error();
@@ -263,6 +274,10 @@ int deltacheck_parse_optionst::doit()
     {
       std::string path1=get_directory(cmdline.args[0]);
       std::string path2=get_directory(cmdline.args[1]);
+
+      // for keeping results next to the binaries
+      options.set_option("binary-old", cmdline.args[0]);
+      options.set_option("binary-new", cmdline.args[1]);
     
       deltacheck_analyzer(
         path1, goto_model1,
@@ -330,6 +345,11 @@ void deltacheck_parse_optionst::help()
     " --show-change-impact         show syntactic change-impact\n"
     " --description-old text       description of old version\n"
     " --description-new text       description of new version\n"
+    " --jobs N                     analyse N functions in parallel\n"
+    " --cache dir                  reuse results of unchanged functions\n"
+    "                              and the loop invariants of earlier runs\n"
+    " --widening-delay n           widen loops after n iterations\n"
+    "                              (default: 10)\n"
     "\n"
     "Safety checks:\n"
     " --bounds-check               add array bounds checks\n"
@@ -17,7 +17,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <cbmc/xml_interface.h>
 
 #define DELTACHECK_OPTIONS \
-  "(function):" \
+  "(function):(jobs):(cache):(widening-delay):" \
   "(debug-level):" \
   "(xml-ui)(xml-interface)" \
   "(verbosity):(version)(index):(description-old):(description-new):" \
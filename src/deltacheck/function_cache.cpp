@@ -0,0 +1,563 @@
+/*******************************************************************\
+
+Module: Cache for the Results of Analysing a Function
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#include <util/i2string.h>
+
+#include "version.h"
+#include "function_cache.h"
+
+// bump when the format of the entries or the
+// analysis changes in a way the version doesn't show
+#define FUNCTION_CACHE_FORMAT "2"
+#define INVARIANT_CACHE_FORMAT "1"
+
+/*******************************************************************\
+
+   Class: fnv_hasht
+
+ Purpose: 64-bit FNV-1a, which, unlike irept::hash, doesn't
+          depend on the platform or on the build
+
+\*******************************************************************/
+
+class fnv_hasht
+{
+public:
+  fnv_hasht():value(14695981039346656037ULL)
+  {
+  }
+
+  void operator()(const std::string &s)
+  {
+    for(unsigned i=0; i<s.size(); i++)
+      byte((unsigned char)s[i]);
+
+    byte(0); // terminator, "ab","c" differs from "a","bc"
+  }
+
+  void operator()(unsigned long long n)
+  {
+    (*this)(i2string((unsigned long)n));
+  }
+
+  void operator()(const char *data, std::size_t size)
+  {
+    for(std::size_t i=0; i<size; i++)
+      byte((unsigned char)data[i]);
+  }
+
+  std::string str() const
+  {
+    char buffer[20];
+    sprintf(buffer, "%016llx", value);
+    return buffer;
+  }
+
+protected:
+  unsigned long long value;
+
+  inline void byte(unsigned char c)
+  {
+    value^=c;
+    value*=1099511628211ULL;
+  }
+};
+
+/*******************************************************************\
+
+Function: hash_irep
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: structural hash that skips the comments, and
+          thus, the source locations of expressions;
+          collects the identifiers of the symbols used
+
+\*******************************************************************/
+
+static void hash_irep(
+  const irept &src,
+  fnv_hasht &hash,
+  std::set<irep_idt> &symbols)
+{
+  hash(id2string(src.id()));
+
+  if(src.id()==ID_symbol)
+    symbols.insert(src.get(ID_identifier));
+
+  const irept::subt &sub=src.get_sub();
+  hash(sub.size());
+
+  forall_irep(it, sub)
+    hash_irep(*it, hash, symbols);
+
+  const irept::named_subt &named_sub=src.get_named_sub();
+  hash(named_sub.size());
+
+  forall_named_irep(it, named_sub)
+  {
+    hash(id2string(it->first));
+    hash_irep(it->second, hash, symbols);
+  }
+}
+
+/*******************************************************************\
+
+Function: hash_body
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+static void hash_body(
+  const goto_functionst::goto_functiont &fkt,
+  fnv_hasht &hash,
+  std::set<irep_idt> &symbols)
+{
+  const goto_programt::instructionst &instructions=
+    fkt.body.instructions;
+
+  hash(instructions.size());
+
+  if(instructions.empty()) return;
+
+  unsigned base=instructions.front().location_number;
+
+  forall_goto_program_instructions(i_it, fkt.body)
+  {
+    hash(i_it->type);
+    hash_irep(i_it->code, hash, symbols);
+    hash_irep(i_it->guard, hash, symbols);
+
+    // The report shows the source code by line.
+    hash(id2string(i_it->source_location.get_file()));
+    hash(id2string(i_it->source_location.get_line()));
+
+    hash(i_it->targets.size());
+
+    for(goto_programt::targetst::const_iterator
+        t_it=i_it->targets.begin();
+        t_it!=i_it->targets.end();
+        t_it++)
+      hash((*t_it)->location_number-base);
+  }
+}
+
+/*******************************************************************\
+
+Function: hash_symbol_types
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: hash the types of the given symbols, and of
+          the symbols these refer to, say struct tags
+
+\*******************************************************************/
+
+static void hash_symbol_types(
+  const std::set<irep_idt> &symbols,
+  const namespacet &ns,
+  fnv_hasht &hash)
+{
+  std::set<irep_idt> done, todo=symbols;
+
+  while(!todo.empty())
+  {
+    irep_idt identifier=*todo.begin();
+    todo.erase(todo.begin());
+
+    if(!done.insert(identifier).second) continue;
+
+    hash(id2string(identifier));
+
+    const symbolt *symbol;
+    if(ns.lookup(identifier, symbol))
+    {
+      hash("?");
+      continue;
+    }
+
+    std::set<irep_idt> referenced;
+    hash_irep(symbol->type, hash, referenced);
+
+    for(std::set<irep_idt>::const_iterator
+        r_it=referenced.begin(); r_it!=referenced.end(); r_it++)
+      if(done.find(*r_it)==done.end())
+        todo.insert(*r_it);
+  }
+}
+
+/*******************************************************************\
+
+Function: function_cachet::key
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+std::string function_cachet::key(
+  const irep_idt &function,
+  const goto_functionst::goto_functiont &fkt_old,
+  const namespacet &ns_old,
+  const goto_functionst::goto_functiont &fkt_new,
+  const namespacet &ns_new,
+  const optionst &options,
+  const std::string &context)
+{
+  fnv_hasht hash;
+
+  hash(FUNCTION_CACHE_FORMAT);
+  hash(DELTACHECK_VERSION);
+  hash(id2string(function));
+
+  // these show up in the report
+  hash(options.get_option("description-old"));
+  hash(options.get_option("description-new"));
+
+  // this changes the loop invariants
+  hash(options.get_option("widening-delay"));
+
+  std::set<irep_idt> symbols_old, symbols_new;
+  symbols_old.insert(function);
+  symbols_new.insert(function);
+
+  hash("old");
+  hash_body(fkt_old, hash, symbols_old);
+  hash_symbol_types(symbols_old, ns_old, hash);
+
+  hash("new");
+  hash_body(fkt_new, hash, symbols_new);
+  hash_symbol_types(symbols_new, ns_new, hash);
+
+  hash("context");
+  hash(context);
+
+  return hash.str();
+}
+
+/*******************************************************************\
+
+Function: function_cachet::loop_key
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: The candidate invariant is checked before it is used,
+          and thus, the key only needs to make that likely to
+          succeed. Unlike key(), we skip the source locations,
+          as a loop that moved is still the same loop.
+
+\*******************************************************************/
+
+std::string function_cachet::loop_key(
+  const irep_idt &function,
+  goto_programt::const_targett backwards_goto,
+  const std::vector<irep_idt> &state_vars)
+{
+  fnv_hasht hash;
+
+  hash(INVARIANT_CACHE_FORMAT);
+  hash(DELTACHECK_VERSION);
+  hash(id2string(function));
+
+  goto_programt::const_targett head=backwards_goto->get_target();
+  unsigned base=head->location_number;
+  std::set<irep_idt> symbols;
+
+  hash(backwards_goto->location_number-base);
+
+  for(goto_programt::const_targett i_it=head; ; i_it++)
+  {
+    hash(i_it->type);
+    hash_irep(i_it->code, hash, symbols);
+    hash_irep(i_it->guard, hash, symbols);
+
+    hash(i_it->targets.size());
+
+    for(goto_programt::targetst::const_iterator
+        t_it=i_it->targets.begin();
+        t_it!=i_it->targets.end();
+        t_it++)
+      hash((*t_it)->location_number-base);
+
+    if(i_it==backwards_goto) break;
+  }
+
+  hash(state_vars.size());
+
+  for(std::vector<irep_idt>::const_iterator
+      s_it=state_vars.begin();
+      s_it!=state_vars.end();
+      s_it++)
+    hash(id2string(*s_it));
+
+  return hash.str();
+}
+
+/*******************************************************************\
+
+Function: function_cachet::file_key
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+std::string function_cachet::file_key(const std::string &file_name)
+{
+  std::ifstream in(file_name.c_str(), std::ios::binary);
+  if(!in) return "";
+
+  fnv_hasht hash;
+
+  hash(FUNCTION_CACHE_FORMAT);
+  hash(DELTACHECK_VERSION);
+
+  char buffer[65536];
+
+  while(in.read(buffer, sizeof(buffer)) || in.gcount()!=0)
+    hash(buffer, in.gcount());
+
+  if(in.bad()) return "";
+
+  return hash.str();
+}
+
+/*******************************************************************\
+
+Function: function_cachet::file_name
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+std::string function_cachet::file_name(const std::string &key) const
+{
+  return directory+"/"+key;
+}
+
+/*******************************************************************\
+
+Function: function_cachet::lookup
+
+  Inputs:
+
+ Outputs: true if found
+
+ Purpose:
+
+\*******************************************************************/
+
+bool function_cachet::lookup(const std::string &key, entryt &entry) const
+{
+  std::ifstream in(file_name(key).c_str(), std::ios::binary);
+  if(!in) return false;
+
+  std::string line;
+
+  if(!std::getline(in, line) ||
+     line!="deltacheck-cache " FUNCTION_CACHE_FORMAT)
+    return false;
+
+  if(!std::getline(in, line) ||
+     line.size()<2 || line[0]!='S')
+    return false;
+
+  entry.property_status=line.substr(2);
+
+  entry.property_ids.clear();
+  entry.property_comments.clear();
+
+  // "P id comment", one per property
+  for(unsigned p=0; p<entry.property_status.size(); p++)
+  {
+    if(!std::getline(in, line) ||
+       line.size()<2 || line[0]!='P')
+      return false;
+
+    std::size_t space=line.find(' ', 2);
+
+    if(space==std::string::npos)
+      return false;
+
+    entry.property_ids.push_back(line.substr(2, space-2));
+    entry.property_comments.push_back(line.substr(space+1));
+  }
+
+  entry.report.assign(
+    std::istreambuf_iterator<char>(in),
+    std::istreambuf_iterator<char>());
+
+  return true;
+}
+
+/*******************************************************************\
+
+Function: function_cachet::store
+
+  Inputs:
+
+ Outputs: true on error
+
+ Purpose: Several processes may store the same entry at the
+          same time. We write a temporary file first, and rename
+          it, and thus, a reader never sees a partial entry.
+
+\*******************************************************************/
+
+bool function_cachet::store(const std::string &key, const entryt &entry) const
+{
+  std::string final_name=file_name(key);
+  std::string tmp_name=final_name+".tmp"+i2string((unsigned long)getpid());
+
+  {
+    std::ofstream out(tmp_name.c_str(), std::ios::binary);
+
+    out << "deltacheck-cache " FUNCTION_CACHE_FORMAT "\n";
+    out << "S " << entry.property_status << "\n";
+
+    for(unsigned p=0; p<entry.property_ids.size(); p++)
+      out << "P " << entry.property_ids[p] << " "
+          << entry.property_comments[p] << "\n";
+
+    out << entry.report;
+
+    out.close();
+
+    if(!out)
+    {
+      remove(tmp_name.c_str());
+      return true;
+    }
+  }
+
+  if(rename(tmp_name.c_str(), final_name.c_str())!=0)
+  {
+    remove(tmp_name.c_str());
+    return true;
+  }
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: function_cachet::lookup
+
+  Inputs:
+
+ Outputs: true if found
+
+ Purpose:
+
+\*******************************************************************/
+
+bool function_cachet::lookup(
+  const std::string &key,
+  invariantt &invariant) const
+{
+  std::ifstream in(file_name(key).c_str());
+  if(!in) return false;
+
+  std::string line;
+
+  if(!std::getline(in, line) ||
+     line!="deltacheck-invariant " INVARIANT_CACHE_FORMAT)
+    return false;
+
+  unsigned size;
+  if(!(in >> invariant.iterations >> size))
+    return false;
+
+  invariant.classes.resize(size);
+
+  for(unsigned v=0; v<size; v++)
+    if(!(in >> invariant.classes[v]) ||
+       invariant.classes[v]>=size)
+      return false;
+
+  return true;
+}
+
+/*******************************************************************\
+
+Function: function_cachet::store
+
+  Inputs:
+
+ Outputs: true on error
+
+ Purpose: as above, via a temporary file
+
+\*******************************************************************/
+
+bool function_cachet::store(
+  const std::string &key,
+  const invariantt &invariant) const
+{
+  std::string final_name=file_name(key);
+  std::string tmp_name=final_name+".tmp"+i2string((unsigned long)getpid());
+
+  {
+    std::ofstream out(tmp_name.c_str());
+
+    out << "deltacheck-invariant " INVARIANT_CACHE_FORMAT "\n";
+    out << invariant.iterations << " "
+        << invariant.classes.size() << "\n";
+
+    for(unsigned v=0; v<invariant.classes.size(); v++)
+      out << (v==0?"":" ") << invariant.classes[v];
+
+    out << "\n";
+
+    out.close();
+
+    if(!out)
+    {
+      remove(tmp_name.c_str());
+      return true;
+    }
+  }
+
+  if(rename(tmp_name.c_str(), final_name.c_str())!=0)
+  {
+    remove(tmp_name.c_str());
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,97 @@
+/*******************************************************************\
+
+Module: Cache for the Results of Analysing a Function
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#ifndef CPROVER_DELTACHECK_FUNCTION_CACHE_H
+#define CPROVER_DELTACHECK_FUNCTION_CACHE_H
+
+#include <string>
+#include <vector>
+
+#include <util/options.h>
+#include <util/namespace.h>
+#include <goto-programs/goto_functions.h>
+
+// The results are kept in a directory, one file per
+// function, named by a hash of everything the analysis
+// of the function depends on.
+
+class function_cachet
+{
+public:
+  explicit function_cachet(const std::string &_directory):
+    directory(_directory)
+  {
+  }
+
+  // what we keep for a function
+  struct entryt
+  {
+    // one of P(assed), F(ailed), U(nknown) per property
+    std::string property_status;
+
+    // the id and the comment of each property, in the
+    // same order, for the lines on the console
+    std::vector<std::string> property_ids, property_comments;
+
+    // the HTML report, which includes the countermodels
+    std::string report;
+  };
+
+  // Hash of the old and new body, the types of the
+  // symbols used, the options that matter, and whatever
+  // else the analysis starts from, given as text.
+  static std::string key(
+    const irep_idt &function,
+    const goto_functionst::goto_functiont &fkt_old,
+    const namespacet &ns_old,
+    const goto_functionst::goto_functiont &fkt_new,
+    const namespacet &ns_new,
+    const optionst &options,
+    const std::string &context);
+
+  // Hash of the contents of a file, say a goto binary,
+  // and of the version; empty if the file can't be read.
+  static std::string file_key(const std::string &file_name);
+
+  // true if found
+  bool lookup(const std::string &key, entryt &) const;
+
+  // true on error
+  bool store(const std::string &key, const entryt &) const;
+
+  // The invariant of a loop, as computed for some earlier
+  // revision. The fixed point for the loop may start from it.
+  struct invariantt
+  {
+    // the number of a representative for each state variable
+    std::vector<unsigned> classes;
+
+    // what the fixed point took when computed from scratch
+    unsigned iterations;
+  };
+
+  // Hash of the function name, of the instructions of the
+  // loop, and of the identifiers of the state variables.
+  static std::string loop_key(
+    const irep_idt &function,
+    goto_programt::const_targett backwards_goto,
+    const std::vector<irep_idt> &state_vars);
+
+  // true if found
+  bool lookup(const std::string &key, invariantt &) const;
+
+  // true on error
+  bool store(const std::string &key, const invariantt &) const;
+
+protected:
+  std::string directory;
+
+  std::string file_name(const std::string &key) const;
+};
+
+#endif
@@ -106,18 +106,41 @@ void report_properties(
       p_it=properties.begin();
       p_it!=properties.end();
       p_it++)
-  {
-    message.status()
-      << "[" << p_it->loc->source_location.get_property_id() << "] "
-      << p_it->loc->source_location.get_comment() << ": ";
-    if(p_it->status.is_true())
-      message.status() << "OK";
-    else if(p_it->status.is_false())
-      message.status() << "FAILED";
-    else
-      message.status() << "UNKNOWN";
-    message.status() << messaget::eom;
-  }
+    report_property(
+      p_it->loc->source_location.get_property_id(),
+      p_it->loc->source_location.get_comment(),
+      p_it->status,
+      message);
+}
+
+/*******************************************************************\
+
+Function: report_property
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void report_property(
+  const irep_idt &property_id,
+  const irep_idt &comment,
+  const tvt &status,
+  messaget &message)
+{
+  message.status()
+    << "[" << property_id << "] "
+    << comment << ": ";
+  if(status.is_true())
+    message.status() << "OK";
+  else if(status.is_false())
+    message.status() << "FAILED";
+  else
+    message.status() << "UNKNOWN";
+  message.status() << messaget::eom;
 }
 
 /*******************************************************************\
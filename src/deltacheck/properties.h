@@ -38,6 +38,13 @@ void report_properties(
   const propertiest &,
   messaget &);
 
+// the line for one property, as given by the above
+void report_property(
+  const irep_idt &property_id,
+  const irep_idt &comment,
+  const tvt &status,
+  messaget &);
+
 void report_countermodels(
   const local_SSAt &,
   const propertiest &,
@@ -8,6 +8,10 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #define DEBUG
 
+#include <algorithm>
+
+#include <util/i2string.h>
+
 #include <solvers/sat/satcheck.h>
 #include <solvers/flattening/bv_pointers.h>
 
@@ -91,29 +95,193 @@ void ssa_fixed_pointt::tie_inputs_together(std::list<exprt> &dest)
 
 /*******************************************************************\
 
-Function: ssa_fixed_pointt::do_backwards_edge
+Function: loop_depths
 
   Inputs:
 
  Outputs:
 
- Purpose:
+ Purpose: How deep each component is nested, where the
+          outermost ones have depth zero.
+
+\*******************************************************************/
+
+static void loop_depths(const wtot &wto, std::vector<unsigned> &dest)
+{
+  dest.assign(wto.components.size(), 0);
+
+  // the enclosing components come after the ones inside
+  for(unsigned nr=wto.components.size(); nr!=0; nr--)
+  {
+    const wtot::componentt &component=wto.components[nr-1];
+
+    for(std::vector<unsigned>::const_iterator
+        c_it=component.children.begin();
+        c_it!=component.children.end();
+        c_it++)
+      dest[*c_it]=dest[nr-1]+1;
+  }
+}
+
+/*******************************************************************\
+
+Function: same_instruction
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: As in change_impactt::diff_functions.
+
+\*******************************************************************/
+
+static bool same_instruction(
+  const goto_programt::instructiont &i1,
+  const goto_programt::instructiont &i2)
+{
+  return i1.type==i2.type &&
+         i1.guard==i2.guard &&
+         i1.code==i2.code;
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::pair_loops
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: If both functions have loops of the same shape,
+          we pair them in order, inner loops first. Otherwise,
+          some loop was added or removed, and we pair the
+          loops that are nested equally deep and have the
+          same head and backwards goto, by the longest common
+          subsequence of the loops in order.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::pair_loops()
+{
+  wtot wto_old(SSA_old.goto_function.body);
+  wtot wto_new(SSA_new.goto_function.body);
+
+  const wtot::componentst &c_old=wto_old.components;
+  const wtot::componentst &c_new=wto_new.components;
+
+  bool same_shape=c_old.size()==c_new.size();
+
+  for(unsigned i=0; same_shape && i<c_new.size(); i++)
+    if(c_old[i].children.size()!=c_new[i].children.size())
+      same_shape=false;
+
+  if(same_shape)
+  {
+    for(unsigned i=0; i<c_new.size(); i++)
+      loop_pairs.push_back(
+        std::make_pair(c_old[i].backwards_goto, c_new[i].backwards_goto));
+
+    return;
+  }
+
+  std::vector<unsigned> depth_old, depth_new;
+  loop_depths(wto_old, depth_old);
+  loop_depths(wto_new, depth_new);
+
+  const unsigned m=c_old.size(), n=c_new.size();
+
+  std::vector<std::vector<bool> > same(m, std::vector<bool>(n, false));
+
+  for(unsigned i=0; i<m; i++)
+    for(unsigned j=0; j<n; j++)
+      same[i][j]=depth_old[i]==depth_new[j] &&
+                 same_instruction(*c_old[i].head, *c_new[j].head) &&
+                 same_instruction(*c_old[i].backwards_goto,
+                                  *c_new[j].backwards_goto);
+
+  // the length of the longest common subsequence
+  // of the loops from i and j on
+  std::vector<std::vector<unsigned> > lcs(
+    m+1, std::vector<unsigned>(n+1, 0));
+
+  for(unsigned i=m; i!=0; i--)
+    for(unsigned j=n; j!=0; j--)
+      lcs[i-1][j-1]=same[i-1][j-1]?lcs[i][j]+1:
+                    std::max(lcs[i][j-1], lcs[i-1][j]);
+
+  for(unsigned i=0, j=0; i<m && j<n; )
+  {
+    if(same[i][j])
+    {
+      loop_pairs.push_back(
+        std::make_pair(c_old[i].backwards_goto, c_new[j].backwards_goto));
+      i++;
+      j++;
+    }
+    else if(lcs[i+1][j]>=lcs[i][j+1])
+      i++;
+    else
+      j++;
+  }
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::tie_loops_together
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Paired loops take the backwards goto together.
 
 \*******************************************************************/
 
-void ssa_fixed_pointt::do_backwards_edge(
+void ssa_fixed_pointt::tie_loops_together(std::list<exprt> &dest)
+{
+  ssa_objectt guard=SSA_new.guard_symbol();
+
+  for(loop_pairst::const_iterator
+      p_it=loop_pairs.begin();
+      p_it!=loop_pairs.end();
+      p_it++)
+  {
+    symbol_exprt select_old=
+      SSA_old.name(guard, local_SSAt::LOOP_SELECT, p_it->first);
+    symbol_exprt select_new=
+      SSA_new.name(guard, local_SSAt::LOOP_SELECT, p_it->second);
+
+    dest.push_back(equal_exprt(select_old, select_new));
+  }
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::add_state_vars
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Record the objects modified by the loop to get
+          'primed' (post-state) and 'unprimed' (pre-state)
+          variables. The others have no phi node at the loop
+          head.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::add_state_vars(
   const local_SSAt &SSA,
-  locationt from)
+  locationt from,
+  fixed_pointt &fixed_point,
+  std::vector<irep_idt> &ids) const
 {
-  assert(from->is_backwards_goto());
-  
-  //locationt to=from->get_target();
+  local_SSAt::objectst objects;
+  SSA.loop_objects(from, objects);
 
-  // Record the objects modified by the loop to get
-  // 'primed' (post-state) and 'unprimed' (pre-state) variables.
   for(local_SSAt::objectst::const_iterator
-      o_it=SSA.ssa_objects.objects.begin();
-      o_it!=SSA.ssa_objects.objects.end();
+      o_it=objects.begin();
+      o_it!=objects.end();
       o_it++)
   {
     symbol_exprt in=SSA.name(*o_it, local_SSAt::LOOP_BACK, from);
@@ -121,11 +289,319 @@ void ssa_fixed_pointt::do_backwards_edge(
   
     fixed_point.pre_state_vars.push_back(in);
     fixed_point.post_state_vars.push_back(out);
+    ids.push_back(id2string(o_it->get_identifier())+SSA.suffix);
   }
 
   ssa_objectt guard=SSA.guard_symbol();
   fixed_point.pre_state_vars.push_back(SSA.name(guard, local_SSAt::LOOP_BACK, from));
   fixed_point.post_state_vars.push_back(SSA.name(guard, local_SSAt::OUT, from));
+  ids.push_back(id2string(guard.get_identifier())+SSA.suffix);
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::do_component
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: The fixed point for one loop, following Bourdoncle's
+          recursive strategy: whenever the state predicate of
+          the loop changes, the loops nested in it are
+          stabilized again, assuming the current state
+          predicates of the enclosing loops (the context).
+          The invariants of the loops done so far are part of
+          the transition relation.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::do_component(
+  const componentst &components,
+  unsigned nr,
+  const ssa_slicert &slicer,
+  const std::list<exprt> &context)
+{
+  const componentt &component=components[nr];
+  loopt &loop=*component.loop;
+  const local_SSAt &SSA=*loop.SSA;
+  locationt from=loop.loc;
+
+  const std::string name=loop_name(loop);
+  statistics.start(name);
+
+  fixed_pointt fixed_point(ns);
+  fixed_point.widening_delay=widening_delay;
+
+  // A paired old and new loop get one fixed point over the
+  // objects of both, which keeps the equalities between them.
+  std::vector<irep_idt> state_vars;
+
+  if(loop.with_old)
+    add_state_vars(SSA_old, loop.loc_old, fixed_point, state_vars);
+
+  add_state_vars(SSA, from, fixed_point, state_vars);
+
+  // the loop select of the old loop is tied to this one
+  fixed_point.back_edge=
+    SSA.name(SSA.guard_symbol(), local_SSAt::LOOP_SELECT, from);
+
+  // The fixed point needs the cone of the loop only.
+  std::vector<exprt> loop_seeds(
+    fixed_point.post_state_vars.begin(),
+    fixed_point.post_state_vars.end());
+
+  std::list<exprt> slice;
+  slicer(loop_seeds, slice);
+  constraints_total+=slicer.size();
+  constraints_sliced+=slice.size();
+
+  // Have we got the invariant of an earlier revision?
+  if(cache!=NULL && loop.key.empty())
+  {
+    loop.key=function_cachet::loop_key(function, from, state_vars);
+    loop.has_candidate=
+      cache->lookup(loop.key, loop.candidate) &&
+      loop.candidate.classes.size()==fixed_point.pre_state_vars.size();
+  }
+
+  bool warm=loop.has_candidate;
+  predicatet candidate;
+
+  if(warm)
+  {
+    candidate.state_vars=fixed_point.pre_state_vars;
+    candidate.set_classes(loop.candidate.classes);
+  }
+
+  // the iterations of the candidate that didn't make it
+  unsigned rejected_iterations=0;
+
+  if(component.children.empty())
+  {
+    // nothing nested, the transition relation is fixed
+    fixed_point.transition_relation.swap(slice);
+    add_invariants(fixed_point.transition_relation);
+    fixed_point.transition_relation.insert(
+      fixed_point.transition_relation.end(),
+      context.begin(), context.end());
+
+    if(!warm || !fixed_point.check(candidate))
+    {
+      if(warm)
+      {
+        rejected_iterations=fixed_point.iteration_number;
+        warm=false;
+      }
+
+      fixed_point();
+    }
+  }
+  else
+  {
+    if(warm)
+      fixed_point.initialize(candidate);
+    else
+      fixed_point.initialize();
+
+    bool change;
+
+    do
+    {
+      // The invariants of the loops inside only hold
+      // for the previous state predicate.
+      for(unsigned i=component.first; i<nr; i++)
+        components[i].loop->invariant=predicatet();
+
+      std::list<exprt> inner_context(context);
+      fixed_point.state_predicate.get_constraints(inner_context);
+
+      for(std::vector<unsigned>::const_iterator
+          c_it=component.children.begin();
+          c_it!=component.children.end();
+          c_it++)
+        do_component(components, *c_it, slicer, inner_context);
+
+      fixed_point.transition_relation=slice;
+      add_invariants(fixed_point.transition_relation);
+      fixed_point.transition_relation.insert(
+        fixed_point.transition_relation.end(),
+        context.begin(), context.end());
+
+      change=fixed_point.step();
+
+      if(warm && change)
+      {
+        // not a fixed point, start over from 'false'
+        rejected_iterations=fixed_point.iteration_number;
+        warm=false;
+        fixed_point.initialize();
+      }
+    }
+    while(change);
+
+    fixed_point.narrow();
+  }
+
+  if(fixed_point.widened)
+    widenings++;
+
+  if(warm)
+    loop.cold_iterations=loop.candidate.iterations;
+  else
+    loop.cold_iterations=fixed_point.iteration_number;
+
+  // The loops inside are stabilized again whenever the state
+  // predicate of the loops around them changes, and we count
+  // the candidate of a loop the first time only.
+  if(!loop.stabilized && loop.has_candidate)
+  {
+    if(warm)
+    {
+      invariants_reused++;
+
+      if(loop.cold_iterations>fixed_point.iteration_number)
+        iterations_saved+=
+          loop.cold_iterations-fixed_point.iteration_number;
+    }
+    else
+      invariants_rejected++;
+  }
+
+  loop.stabilized=true;
+
+  unsigned iterations=rejected_iterations+fixed_point.iteration_number;
+
+  loop.invariant=fixed_point.state_predicate;
+  loop.iterations+=iterations;
+  statistics.number_map[name+" iterations"]+=iterations;
+
+  statistics.stop(name);
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::merge_components
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Sibling components of the old and the new function,
+          in program order, where a paired old and new loop
+          make one component. The loops of the old function go
+          first.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::merge_components(
+  const wtot &wto_old,
+  const std::vector<unsigned> &nrs_old,
+  const wtot &wto_new,
+  const std::vector<unsigned> &nrs_new,
+  const std::map<unsigned, unsigned> &paired,
+  std::vector<component_pairt> &dest) const
+{
+  std::vector<unsigned>::const_iterator o_it=nrs_old.begin();
+
+  for(std::vector<unsigned>::const_iterator
+      n_it=nrs_new.begin();
+      n_it!=nrs_new.end();
+      n_it++)
+  {
+    const wtot::componentt *c_new=&wto_new.components[*n_it];
+
+    // Paired loops that are nested in loops that aren't
+    // stay apart.
+    std::map<unsigned, unsigned>::const_iterator p_it=
+      paired.find(*n_it);
+
+    std::vector<unsigned>::const_iterator match=
+      p_it==paired.end()?nrs_old.end():
+      std::find(o_it, nrs_old.end(), p_it->second);
+
+    if(match==nrs_old.end())
+    {
+      dest.push_back(component_pairt(NULL, c_new));
+      continue;
+    }
+
+    for(; o_it!=match; o_it++)
+      dest.push_back(component_pairt(&wto_old.components[*o_it], NULL));
+
+    dest.push_back(component_pairt(&wto_old.components[*match], c_new));
+    o_it++;
+  }
+
+  for(; o_it!=nrs_old.end(); o_it++)
+    dest.push_back(component_pairt(&wto_old.components[*o_it], NULL));
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::add_component
+
+  Inputs:
+
+ Outputs: the number of the component
+
+ Purpose: Adds the components inside first, and then the loop.
+
+\*******************************************************************/
+
+unsigned ssa_fixed_pointt::add_component(
+  const wtot &wto_old,
+  const wtot &wto_new,
+  const component_pairt &pair,
+  const std::map<unsigned, unsigned> &paired,
+  componentst &components)
+{
+  static const std::vector<unsigned> none;
+
+  std::vector<component_pairt> inner;
+  merge_components(
+    wto_old, pair.first==NULL?none:pair.first->children,
+    wto_new, pair.second==NULL?none:pair.second->children,
+    paired, inner);
+
+  componentt component;
+  component.first=components.size();
+
+  for(std::vector<component_pairt>::const_iterator
+      i_it=inner.begin();
+      i_it!=inner.end();
+      i_it++)
+    component.children.push_back(
+      add_component(wto_old, wto_new, *i_it, paired, components));
+
+  loops.push_back(loopt());
+  loopt &loop=loops.back();
+
+  if(pair.second==NULL)
+  {
+    loop.SSA=&SSA_old;
+    loop.loc=pair.first->backwards_goto;
+    loop.with_old=false;
+  }
+  else
+  {
+    loop.SSA=&SSA_new;
+    loop.loc=pair.second->backwards_goto;
+    loop.with_old=pair.first!=NULL;
+
+    if(loop.with_old)
+      loop.loc_old=pair.first->backwards_goto;
+  }
+
+  loop.iterations=0;
+  loop.stabilized=false;
+  loop.has_candidate=false;
+  loop.cold_iterations=0;
+
+  component.loop=&loop;
+  components.push_back(component);
+
+  return components.size()-1;
 }
 
 /*******************************************************************\
@@ -136,28 +612,438 @@ Function: ssa_fixed_pointt::do_backwards_edges
 
  Outputs:
 
+ Purpose: A fixed point per loop alone would lose the equalities
+          between the objects of corresponding old and new loops,
+          and thus, a paired old and new loop get one fixed point.
+          We can do so if the loops they are nested in are paired
+          as well.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::do_backwards_edges(const ssa_slicert &slicer)
+{
+  // the old program, if applicable, and the new program
+  const goto_programt empty;
+  wtot wto_old(use_old?SSA_old.goto_function.body:empty);
+  wtot wto_new(SSA_new.goto_function.body);
+
+  #ifdef DEBUG
+  if(use_old)
+  {
+    std::cout << "WTO (old): ";
+    wto_old.output(std::cout);
+  }
+
+  std::cout << "WTO: ";
+  wto_new.output(std::cout);
+  #endif
+
+  // the old component of a paired new one
+  std::map<unsigned, unsigned> paired;
+
+  for(loop_pairst::const_iterator
+      p_it=loop_pairs.begin();
+      p_it!=loop_pairs.end();
+      p_it++)
+  {
+    unsigned nr_old=0, nr_new=0;
+
+    while(wto_old.components[nr_old].backwards_goto!=p_it->first)
+      nr_old++;
+
+    while(wto_new.components[nr_new].backwards_goto!=p_it->second)
+      nr_new++;
+
+    paired[nr_new]=nr_old;
+  }
+
+  std::vector<component_pairt> top_level;
+  merge_components(
+    wto_old, wto_old.top_level,
+    wto_new, wto_new.top_level,
+    paired, top_level);
+
+  componentst components;
+  std::vector<unsigned> nrs;
+
+  for(std::vector<component_pairt>::const_iterator
+      t_it=top_level.begin();
+      t_it!=top_level.end();
+      t_it++)
+    nrs.push_back(
+      add_component(wto_old, wto_new, *t_it, paired, components));
+
+  const std::list<exprt> context;
+
+  for(std::vector<unsigned>::const_iterator
+      n_it=nrs.begin();
+      n_it!=nrs.end();
+      n_it++)
+    do_component(components, *n_it, slicer, context);
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::loop_name
+
+  Inputs:
+
+ Outputs:
+
  Purpose:
 
 \*******************************************************************/
 
-void ssa_fixed_pointt::do_backwards_edges()
+std::string ssa_fixed_pointt::loop_name(const loopt &loop) const
 {
-  // old program, if applicable
+  std::string result="Loop ";
+
+  if(loop.with_old)
+    result+=i2string(loop.loc_old->location_number)+" (old) and ";
+
+  result+=i2string(loop.loc->location_number);
+
   if(use_old)
-  {  
-    forall_goto_program_instructions(i_it, SSA_old.goto_function.body)
+    result+=(loop.SSA==&SSA_old)?" (old)":" (new)";
+
+  return result;
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::accelerate_loop
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: The bounds of the induction variables may fail to
+          hold when the values wrap around, and thus, we check
+          them with the SAT solver: assuming all of them when
+          coming back along the backwards goto, we drop the ones
+          that fail the next time, until nothing changes.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::accelerate_loop(
+  const local_SSAt &SSA,
+  const ssa_inductiont &induction,
+  locationt from,
+  const ssa_slicert &slicer)
+{
+  ssa_inductiont::boundst bounds;
+  induction_variables+=induction(from, bounds);
+
+  if(bounds.empty()) return;
+
+  induction_candidates+=bounds.size();
+
+  std::vector<exprt> pre, post;
+
+  for(ssa_inductiont::boundst::const_iterator
+      b_it=bounds.begin();
+      b_it!=bounds.end();
+      b_it++)
+  {
+    symbol_exprt in=SSA.name(b_it->object, local_SSAt::LOOP_BACK, from);
+    symbol_exprt out=SSA.read_rhs(b_it->object, from);
+
+    pre.push_back(binary_relation_exprt(in, b_it->relation, b_it->bound));
+    post.push_back(binary_relation_exprt(out, b_it->relation, b_it->bound));
+  }
+
+  // we only need the bounds when going back
+  exprt taken=SSA.edge_guard(from, from->get_target());
+
+  std::vector<exprt> seeds(post);
+  seeds.push_back(taken);
+
+  std::list<exprt> slice;
+  slicer(seeds, slice);
+  constraints_total+=slicer.size();
+  constraints_sliced+=slice.size();
+
+  satcheck_no_simplifiert satcheck;
+  bv_pointerst solver(ns, satcheck);
+
+  solver << slice;
+  solver << induction_bounds;
+  solver.set_to_true(taken);
+
+  bvt pre_literals, post_literals;
+
+  for(unsigned i=0; i<pre.size(); i++)
+  {
+    pre_literals.push_back(solver.convert(pre[i]));
+    post_literals.push_back(solver.convert(post[i]));
+  }
+
+  std::vector<bool> alive(pre.size(), true);
+
+  while(true)
+  {
+    // all that are left before, one fails after
+    bvt assumptions, failed;
+
+    for(unsigned i=0; i<alive.size(); i++)
+      if(alive[i])
+      {
+        assumptions.push_back(pre_literals[i]);
+        failed.push_back(!post_literals[i]);
+      }
+
+    if(failed.empty()) break;
+
+    assumptions.push_back(satcheck.lor(failed));
+    satcheck.set_assumptions(assumptions);
+
+    decision_proceduret::resultt result=solver.dec_solve();
+
+    if(result==decision_proceduret::D_UNSATISFIABLE)
+      break;
+
+    if(result!=decision_proceduret::D_SATISFIABLE)
     {
-      if(i_it->is_backwards_goto())
-        do_backwards_edge(SSA_old, i_it);
+      alive.assign(alive.size(), false);
+      break;
     }
+
+    for(unsigned i=0; i<alive.size(); i++)
+      if(alive[i] && satcheck.l_get(post_literals[i]).is_false())
+        alive[i]=false;
   }
 
-  // new program
-  forall_goto_program_instructions(i_it, SSA_new.goto_function.body)
+  for(unsigned i=0; i<alive.size(); i++)
+    if(alive[i])
+    {
+      induction_bounds.push_back(pre[i]);
+      induction_invariants++;
+
+      #ifdef DEBUG
+      std::cout << "INDUCTION: "
+                << from_expr(ns, "", induction_bounds.back()) << "\n";
+      #endif
+    }
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::accelerate
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: The state predicates only have equalities, which
+          say nothing about counters.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::accelerate(const ssa_slicert &slicer)
+{
+  statistics.start("Acceleration");
+
+  if(use_old)
   {
+    ssa_inductiont induction(SSA_old);
+
+    forall_goto_program_instructions(i_it, SSA_old.goto_function.body)
+      if(i_it->is_backwards_goto())
+        accelerate_loop(SSA_old, induction, i_it, slicer);
+  }
+
+  ssa_inductiont induction(SSA_new);
+
+  forall_goto_program_instructions(i_it, SSA_new.goto_function.body)
     if(i_it->is_backwards_goto())
-      do_backwards_edge(SSA_new, i_it);
+      accelerate_loop(SSA_new, induction, i_it, slicer);
+
+  statistics.stop("Acceleration");
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::measure_acceleration
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: What the bounds save, as the fixed points once more
+          without them, in a copy we keep nothing else from.
+          We compare the iterations from 'false', which the
+          cache has for the loops that started from an
+          earlier invariant.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::measure_acceleration(const ssa_slicert &slicer)
+{
+  if(induction_bounds.empty()) return;
+
+  ssa_fixed_pointt plain(*this);
+  plain.loops.clear();
+  plain.induction_bounds.clear();
+  plain.cache=NULL;
+  plain.do_backwards_edges(slicer);
+
+  unsigned with=0, without=0;
+
+  for(loopst::const_iterator
+      l_it=loops.begin(); l_it!=loops.end(); l_it++)
+    with+=l_it->cold_iterations;
+
+  for(loopst::const_iterator
+      l_it=plain.loops.begin(); l_it!=plain.loops.end(); l_it++)
+    without+=l_it->cold_iterations;
+
+  if(without>with)
+    induction_iterations_saved=without-with;
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::houdini_pair
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Houdini: the candidates are the equalities between
+          the variables of the old and the new loop for the
+          same object. We assume all of them before an
+          iteration of both loops, and drop the ones that
+          don't hold after it, until nothing changes. The
+          transition relation goes to the solver only once.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::houdini_pair(
+  locationt loc_old,
+  locationt loc_new,
+  const ssa_slicert &slicer)
+{
+  local_SSAt::objectst objects_old, objects_new;
+  SSA_old.loop_objects(loc_old, objects_old);
+  SSA_new.loop_objects(loc_new, objects_new);
+
+  // the objects both loops change, and the guard
+  std::vector<ssa_objectt> objects;
+
+  for(local_SSAt::objectst::const_iterator
+      o_it=objects_new.begin();
+      o_it!=objects_new.end();
+      o_it++)
+    if(objects_old.find(*o_it)!=objects_old.end())
+      objects.push_back(*o_it);
+
+  objects.push_back(SSA_new.guard_symbol());
+
+  std::vector<exprt> pre_old, pre_new, post_old, post_new;
+
+  for(std::vector<ssa_objectt>::const_iterator
+      o_it=objects.begin();
+      o_it!=objects.end();
+      o_it++)
+  {
+    symbol_exprt in_old=SSA_old.name(*o_it, local_SSAt::LOOP_BACK, loc_old);
+    symbol_exprt in_new=SSA_new.name(*o_it, local_SSAt::LOOP_BACK, loc_new);
+
+    if(in_old.type()!=in_new.type())
+      continue;
+
+    bool is_guard=o_it->get_identifier()==
+                  SSA_new.guard_symbol().get_identifier();
+
+    pre_old.push_back(in_old);
+    pre_new.push_back(in_new);
+    post_old.push_back(is_guard?
+      exprt(SSA_old.name(*o_it, local_SSAt::OUT, loc_old)):
+      exprt(SSA_old.read_rhs(*o_it, loc_old)));
+    post_new.push_back(is_guard?
+      exprt(SSA_new.name(*o_it, local_SSAt::OUT, loc_new)):
+      exprt(SSA_new.read_rhs(*o_it, loc_new)));
   }
+
+  houdini_candidates+=pre_new.size();
+
+  // both loops, and what we know about the loops so far
+  std::vector<exprt> seeds(post_old);
+  seeds.insert(seeds.end(), post_new.begin(), post_new.end());
+
+  std::list<exprt> slice;
+  slicer(seeds, slice);
+  constraints_total+=slicer.size();
+  constraints_sliced+=slice.size();
+
+  solvert solver(ns);
+  solver << slice;
+  solver << correspondences;
+
+  std::vector<bool> alive(pre_new.size(), true);
+  bool change;
+
+  do
+  {
+    houdini_rounds++;
+
+    solver.push();
+
+    for(unsigned i=0; i<alive.size(); i++)
+      if(alive[i])
+        solver.set_to_true(equal_exprt(pre_old[i], pre_new[i]));
+
+    solver.dec_solve();
+
+    change=false;
+
+    for(unsigned i=0; i<alive.size(); i++)
+      if(alive[i] && !solver.is_equal(post_old[i], post_new[i]))
+      {
+        alive[i]=false;
+        change=true;
+      }
+
+    solver.pop();
+  }
+  while(change);
+
+  for(unsigned i=0; i<alive.size(); i++)
+    if(alive[i])
+    {
+      correspondences.push_back(equal_exprt(pre_old[i], pre_new[i]));
+      houdini_invariants++;
+
+      #ifdef DEBUG
+      std::cout << "HOUDINI: "
+                << from_expr(ns, "", correspondences.back()) << "\n";
+      #endif
+    }
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::houdini
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Candidates for the loops we have paired.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::houdini(const ssa_slicert &slicer)
+{
+  statistics.start("Houdini");
+
+  for(loop_pairst::const_iterator
+      p_it=loop_pairs.begin();
+      p_it!=loop_pairs.end();
+      p_it++)
+    houdini_pair(p_it->first, p_it->second, slicer);
+
+  statistics.stop("Houdini");
 }
 
 /*******************************************************************\
@@ -174,28 +1060,183 @@ Function: ssa_fixed_pointt::compute_fixed_point
 
 void ssa_fixed_pointt::compute_fixed_point()
 {
-  do_backwards_edges();
   setup_properties();
 
   // set up transition relation
   
   // new function
-  fixed_point.transition_relation << SSA_new;
+  transition_relation << SSA_new;
 
   if(use_old)
   {
     // old function, if applicable
-    fixed_point.transition_relation << SSA_old;
+    transition_relation << SSA_old;
     
     // tie inputs together, if applicable
-    tie_inputs_together(fixed_point.transition_relation);
+    tie_inputs_together(transition_relation);
+
+    // the corresponding loops iterate together
+    pair_loops();
+    tie_loops_together(transition_relation);
   }
-  
-  // compute the fixed-point
-  fixed_point();
 
-  // we check the properties once we have the fixed point
-  check_properties();
+  ssa_slicert slicer(transition_relation);
+
+  // bounds of the counting loops, which the fixed
+  // points don't find
+  accelerate(slicer);
+
+  // what the old version tells us about the new one
+  if(use_old)
+    houdini(slicer);
+
+  // compute the fixed-points, one per loop
+  do_backwards_edges(slicer);
+
+  // for the statistics
+  measure_acceleration(slicer);
+
+  // for the next revision
+  store_invariants();
+
+  // we check the properties once we have the fixed points
+  check_properties(slicer);
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::output
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::output(std::ostream &out) const
+{
+  for(loopst::const_iterator
+      l_it=loops.begin();
+      l_it!=loops.end();
+      l_it++)
+  {
+    out << "Loop at location " << l_it->loc->location_number << "\n";
+    l_it->invariant.output(out);
+    out << "\n";
+  }
+
+  if(!induction_bounds.empty())
+  {
+    out << "Induction variables\n";
+
+    for(std::list<exprt>::const_iterator
+        b_it=induction_bounds.begin();
+        b_it!=induction_bounds.end();
+        b_it++)
+      out << "Bound: " << from_expr(ns, "", *b_it) << "\n";
+
+    out << "\n";
+  }
+
+  if(!correspondences.empty())
+  {
+    out << "Old and new loops\n";
+
+    for(std::list<exprt>::const_iterator
+        c_it=correspondences.begin();
+        c_it!=correspondences.end();
+        c_it++)
+      out << "Equal: " << from_expr(ns, "", *c_it) << "\n";
+
+    out << "\n";
+  }
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::add_invariants
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::add_invariants(decision_proceduret &dest) const
+{
+  for(loopst::const_iterator
+      l_it=loops.begin();
+      l_it!=loops.end();
+      l_it++)
+    dest << l_it->invariant;
+
+  dest << correspondences;
+  dest << induction_bounds;
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::add_invariants
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::add_invariants(std::list<exprt> &dest) const
+{
+  for(loopst::const_iterator
+      l_it=loops.begin();
+      l_it!=loops.end();
+      l_it++)
+    l_it->invariant.get_constraints(dest);
+
+  dest.insert(dest.end(), correspondences.begin(), correspondences.end());
+  dest.insert(dest.end(), induction_bounds.begin(), induction_bounds.end());
+}
+
+/*******************************************************************\
+
+Function: ssa_fixed_pointt::store_invariants
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: A failure to store merely means that the next
+          revision starts from scratch.
+
+\*******************************************************************/
+
+void ssa_fixed_pointt::store_invariants() const
+{
+  if(cache==NULL) return;
+
+  for(loopst::const_iterator
+      l_it=loops.begin();
+      l_it!=loops.end();
+      l_it++)
+  {
+    if(l_it->key.empty()) continue;
+
+    function_cachet::invariantt invariant;
+    l_it->invariant.get_classes(invariant.classes);
+    invariant.iterations=l_it->cold_iterations;
+
+    if(l_it->has_candidate &&
+       l_it->candidate.classes==invariant.classes &&
+       l_it->candidate.iterations==invariant.iterations)
+      continue; // unchanged
+
+    cache->store(l_it->key, invariant);
+  }
 }
 
 /*******************************************************************\
@@ -210,40 +1251,114 @@ Function: ssa_fixed_pointt::check_properties
 
 \*******************************************************************/
 
-void ssa_fixed_pointt::check_properties()
+void ssa_fixed_pointt::check_properties(const ssa_slicert &slicer)
 {
-  for(propertiest::iterator
-      p_it=properties.begin(); p_it!=properties.end(); p_it++)
+  // We encode the transition relation and the fixed-point for
+  // the SAT solver only when the cheap solver is inconclusive,
+  // and then only once, and check each property under an
+  // assumption. The simplifier would eliminate variables we
+  // still need.
+  satcheck_no_simplifiert satcheck;
+  bv_pointerst sat_solver(ns, satcheck);
+  bool sat_solver_ready=false;
+
+  // The cheap solver only gets properties whose constraints
+  // it can be trusted with; it knows nothing but congruence
+  // about most operators, say, arithmetic, which is sound.
+  bool invariants_trusted=true;
+
   {
-    #if 0
-    solvert solver(ns);
-    #else
-    satcheckt satcheck;
-    bv_pointerst solver(ns, satcheck);
-    //solver.set_message_handler(get_message_handler());
-    #endif
+    std::list<exprt> invariants;
+    add_invariants(invariants);
 
-    // feed transition relation into solver
-    solver << fixed_point.transition_relation;
-    
-    // feed in fixed-point
-    solver << fixed_point.state_predicate;
+    for(std::list<exprt>::const_iterator
+        it=invariants.begin(); it!=invariants.end(); it++)
+      if(!solvert::trusts(*it))
+      {
+        invariants_trusted=false;
+        break;
+      }
+  }
 
+  for(propertiest::iterator
+      p_it=properties.begin(); p_it!=properties.end(); p_it++)
+  {
     #ifdef DEBUG
     std::cout << "GUARD: " << from_expr(ns, "", p_it->guard) << "\n";
     std::cout << "CHECKING: " << from_expr(ns, "", p_it->condition) << "\n";
     #endif
     
-    // feed in the assertion
-    solver.set_to_true(p_it->guard);
-    solver.set_to_false(p_it->condition);
+    // The assertion fails if the guard holds but the condition
+    // doesn't. If the cheap solver finds this inconsistent,
+    // the property holds. It only gets the cone of the property,
+    // which is inconsistent if and only if all of it is.
+    std::vector<exprt> seeds;
+    seeds.push_back(p_it->guard);
+    seeds.push_back(p_it->condition);
+
+    std::list<exprt> slice;
+    slicer(seeds, slice);
+    constraints_total+=slicer.size();
+    constraints_sliced+=slice.size();
+
+    bool trusted=
+      invariants_trusted &&
+      solvert::trusts(p_it->guard) &&
+      solvert::trusts(p_it->condition);
+
+    for(std::list<exprt>::const_iterator
+        it=slice.begin(); trusted && it!=slice.end(); it++)
+      trusted=solvert::trusts(*it);
+
+    decision_proceduret::resultt result=
+      decision_proceduret::D_ERROR;
+
+    if(trusted)
+    {
+      solvert solver(ns);
+      solver << slice;
+      add_invariants(solver);
+      solver.set_to_true(p_it->guard);
+      solver.set_to_false(p_it->condition);
+      result=solver.dec_solve();
+    }
+
+    if(result==decision_proceduret::D_UNSATISFIABLE)
+    {
+      p_it->status=tvt(true);
+      solver_proved++;
+
+      #ifdef DEBUG
+      std::cout << "RESULT: " << p_it->status << " (solver)\n";
+      std::cout << "\n";
+      #endif
+
+      continue;
+    }
+
+    // not conclusive, ask the SAT solver; it gets everything,
+    // as the countermodel shows the values of all symbols
+    if(!sat_solver_ready)
+    {
+      sat_solver << transition_relation;
+      add_invariants(sat_solver);
+      sat_solver_ready=true;
+    }
+
+    literalt property_literal=
+      sat_solver.convert(and_exprt(p_it->guard, not_exprt(p_it->condition)));
+
+    bvt assumptions;
+    assumptions.push_back(property_literal);
+    satcheck.set_assumptions(assumptions);
 
     // now solve
-    decision_proceduret::resultt result=solver.dec_solve();
+    result=sat_solver.dec_solve();
+    sat_checked++;
    
     #ifdef DEBUG
     std::cout << "=======================\n";
-    solver.print_assignment(std::cout);
+    sat_solver.print_assignment(std::cout);
     std::cout << "=======================\n";
     #endif
 
@@ -254,7 +1369,7 @@ void ssa_fixed_pointt::check_properties()
     else if(result==decision_proceduret::D_SATISFIABLE)
     {
       status=tvt(false);
-      generate_countermodel(*p_it, solver);
+      generate_countermodel(*p_it, sat_solver);
     }
     else
       status=tvt::unknown();
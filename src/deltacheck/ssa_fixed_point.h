@@ -12,7 +12,12 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/threeval.h>
 
 #include "../ssa/local_ssa.h"
+#include "../ssa/ssa_slicer.h"
+#include "../ssa/wto.h"
+#include "../ssa/ssa_induction.h"
 #include "properties.h"
+#include "statistics.h"
+#include "function_cache.h"
 #include "../solver/fixed_point.h"
 
 class ssa_fixed_pointt
@@ -23,32 +28,69 @@ public:
   explicit ssa_fixed_pointt(
     const local_SSAt &_SSA_old,
     const local_SSAt &_SSA_new,
-    const namespacet &_ns):
+    const namespacet &_ns,
+    const irep_idt &_function=irep_idt(),
+    const function_cachet *_cache=NULL,
+    unsigned _widening_delay=10):
     SSA_old(_SSA_old),
     SSA_new(_SSA_new),
     ns(_ns),
     use_old(true),
-    fixed_point(_ns)
+    function(_function),
+    cache(_cache),
+    widening_delay(_widening_delay),
+    solver_proved(0),
+    sat_checked(0),
+    constraints_total(0),
+    constraints_sliced(0),
+    invariants_reused(0),
+    invariants_rejected(0),
+    iterations_saved(0),
+    houdini_candidates(0),
+    houdini_invariants(0),
+    houdini_rounds(0),
+    induction_variables(0),
+    induction_candidates(0),
+    induction_invariants(0),
+    induction_iterations_saved(0),
+    widenings(0)
   {
     compute_fixed_point();
   }
 
   explicit ssa_fixed_pointt(
     const local_SSAt &_SSA,
-    const namespacet &_ns):
+    const namespacet &_ns,
+    const irep_idt &_function=irep_idt(),
+    const function_cachet *_cache=NULL,
+    unsigned _widening_delay=10):
     SSA_old(_SSA),
     SSA_new(_SSA),
     ns(_ns),
     use_old(false),
-    fixed_point(_ns)
+    function(_function),
+    cache(_cache),
+    widening_delay(_widening_delay),
+    solver_proved(0),
+    sat_checked(0),
+    constraints_total(0),
+    constraints_sliced(0),
+    invariants_reused(0),
+    invariants_rejected(0),
+    iterations_saved(0),
+    houdini_candidates(0),
+    houdini_invariants(0),
+    houdini_rounds(0),
+    induction_variables(0),
+    induction_candidates(0),
+    induction_invariants(0),
+    induction_iterations_saved(0),
+    widenings(0)
   {
     compute_fixed_point();
   }
 
-  inline void output(std::ostream &out) const
-  {
-    fixed_point.output(out);
-  }
+  void output(std::ostream &) const;
   
 protected:
   const local_SSAt &SSA_old;
@@ -56,25 +98,185 @@ protected:
   const namespacet &ns;
   bool use_old;
 
+  // the loop invariants of earlier revisions are
+  // kept in the cache, if any
+  irep_idt function;
+  const function_cachet *cache;
+
+  // the iterations of each loop before we widen
+  unsigned widening_delay;
+
 public:
   propertiest properties;
-  fixed_pointt fixed_point;
+
+  // both functions; the fixed-point computations
+  // get the slice for their loop only
+  std::list<exprt> transition_relation;
+
+  // an invariant per loop, over the objects the loop
+  // may change, inner loops first
+  struct loopt
+  {
+    const local_SSAt *SSA;
+    locationt loc; // the backwards goto
+
+    // A paired old loop may share the invariant, which is
+    // then over the objects of both loops.
+    bool with_old;
+    locationt loc_old;
+
+    predicatet invariant;
+    unsigned iterations;
+
+    // whether we have done the fixed point before, as
+    // the loops inside other loops are done repeatedly
+    bool stabilized;
+
+    // the invariant of an earlier revision, if any,
+    // which we try first
+    std::string key;
+    bool has_candidate;
+    function_cachet::invariantt candidate;
+
+    // the iterations when starting from 'false'
+    unsigned cold_iterations;
+  };
+
+  typedef std::list<loopt> loopst;
+  loopst loops;
+
+  // the backwards gotos of the loops of the old function
+  // and of the corresponding loops of the new function;
+  // paired loops iterate in lockstep
+  typedef std::list<std::pair<locationt, locationt> > loop_pairst;
+  loop_pairst loop_pairs;
+
+  // Equalities between the state variables of corresponding
+  // loops of the old and the new function that hold when both
+  // loops do the same number of iterations. The fixed points
+  // and the property checks start from them.
+  std::list<exprt> correspondences;
+
+  // bounds on the values of the induction variables of
+  // the loops, in closed form
+  std::list<exprt> induction_bounds;
+
+  // the time and the iterations for each loop; the time
+  // of a loop includes the loops nested in it
+  statisticst statistics;
+
+  // how many properties the cheap solver has proved,
+  // and how many went to the SAT solver
+  unsigned solver_proved, sat_checked;
+
+  // the constraints we would have given to the cheap
+  // solver without slicing, and the ones we gave it
+  unsigned constraints_total, constraints_sliced;
+
+  // the loops for which the invariant of an earlier
+  // revision was a fixed point, the ones for which it
+  // wasn't, and the iterations this saved
+  unsigned invariants_reused, invariants_rejected;
+  unsigned iterations_saved;
+
+  // the candidate equalities of the Houdini pass, the ones
+  // that are inductive, and the solver calls this took
+  unsigned houdini_candidates, houdini_invariants;
+  unsigned houdini_rounds;
+
+  // the induction variables, the bounds we have proposed
+  // for them, and the ones that are invariant
+  unsigned induction_variables, induction_candidates;
+  unsigned induction_invariants;
+
+  // the iterations of the fixed points from 'false' without
+  // the bounds, less the ones with them
+  unsigned induction_iterations_saved;
+
+  // the loops whose fixed point needed widening
+  unsigned widenings;
 
 protected:
   // fixed-point computation  
   void tie_inputs_together(std::list<exprt> &dest);
+  void pair_loops();
+  void tie_loops_together(std::list<exprt> &dest);
   void compute_fixed_point();
   bool iteration();
   void initialize_invariant();
 
-  void do_backwards_edge(
-    const local_SSAt &SSA, locationt loc);
-  
-  void do_backwards_edges();
+  // the loops in the order we stabilize them, a paired
+  // old and new loop being one component
+  struct componentt
+  {
+    loopt *loop;
+
+    // the components directly inside, in program order
+    std::vector<unsigned> children;
+
+    // All components inside have the numbers from 'first'
+    // up to, but excluding, the one of this component.
+    unsigned first;
+  };
+
+  typedef std::vector<componentt> componentst;
+
+  void add_state_vars(
+    const local_SSAt &SSA,
+    locationt from,
+    fixed_pointt &,
+    std::vector<irep_idt> &ids) const;
+
+  void do_component(
+    const componentst &,
+    unsigned nr,
+    const ssa_slicert &,
+    const std::list<exprt> &context);
+
+  typedef std::pair<const wtot::componentt *,
+                    const wtot::componentt *> component_pairt;
+
+  unsigned add_component(
+    const wtot &wto_old,
+    const wtot &wto_new,
+    const component_pairt &,
+    const std::map<unsigned, unsigned> &paired,
+    componentst &);
+
+  void merge_components(
+    const wtot &wto_old,
+    const std::vector<unsigned> &nrs_old,
+    const wtot &wto_new,
+    const std::vector<unsigned> &nrs_new,
+    const std::map<unsigned, unsigned> &paired,
+    std::vector<component_pairt> &dest) const;
+
+  void do_backwards_edges(const ssa_slicert &);
+
+  void accelerate(const ssa_slicert &);
+  void measure_acceleration(const ssa_slicert &);
+
+  void accelerate_loop(
+    const local_SSAt &SSA,
+    const ssa_inductiont &,
+    locationt loc,
+    const ssa_slicert &);
+
+  void houdini(const ssa_slicert &);
+
+  void houdini_pair(
+    locationt loc_old, locationt loc_new, const ssa_slicert &);
+
+  std::string loop_name(const loopt &) const;
+
+  void add_invariants(decision_proceduret &) const;
+  void add_invariants(std::list<exprt> &) const;
+
+  void store_invariants() const;
 
   // properties
   void setup_properties();
-  void check_properties();
+  void check_properties(const ssa_slicert &);
 
   void countermodel_expr(
     const exprt &src,
@@ -7,6 +7,7 @@ Author: Daniel Kroening, kroening@kroening.com
 \*******************************************************************/
 
 #include <cassert>
+#include <cstdlib>
 
 #include "../html/html_escape.h"
 #include "statistics.h"
@@ -140,3 +141,105 @@ void statisticst::html_report_last(std::ostream &out) const
   out << "\n</p>\n";
 }
 
+
+/*******************************************************************\
+
+Function: statisticst::merge
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void statisticst::merge(const statisticst &other)
+{
+  for(number_mapt::const_iterator
+      it=other.number_map.begin(); it!=other.number_map.end(); it++)
+    number_map[it->first]+=it->second;
+
+  for(time_mapt::const_iterator
+      it=other.time_map.begin(); it!=other.time_map.end(); it++)
+  {
+    timet &t=time_map[it->first];
+    t.total+=it->second.total;
+    t.last=it->second.last;
+  }
+}
+
+/*******************************************************************\
+
+Function: statisticst::write
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: one line per entry, the name goes last as it
+          may contain blanks
+
+\*******************************************************************/
+
+void statisticst::write(std::ostream &out) const
+{
+  for(number_mapt::const_iterator
+      it=number_map.begin(); it!=number_map.end(); it++)
+    out << "N " << it->second << " " << it->first << "\n";
+
+  for(time_mapt::const_iterator
+      it=time_map.begin(); it!=time_map.end(); it++)
+    out << "T " << it->second.total.get_t() << " "
+        << it->second.last.get_t() << " "
+        << it->first << "\n";
+
+  out << "E\n";
+}
+
+/*******************************************************************\
+
+Function: statisticst::read
+
+  Inputs:
+
+ Outputs: true on error, e.g., when the input is truncated
+
+ Purpose: reads what statisticst::write produces
+
+\*******************************************************************/
+
+bool statisticst::read(std::istream &in)
+{
+  std::string line;
+
+  while(std::getline(in, line))
+  {
+    if(line=="E") return false;
+
+    if(line.size()>=2 && line[0]=='N')
+    {
+      std::size_t space=line.find(' ', 2);
+      if(space==std::string::npos) return true;
+      number_map[line.substr(space+1)]+=
+        strtoul(line.substr(2, space-2).c_str(), NULL, 10);
+    }
+    else if(line.size()>=2 && line[0]=='T')
+    {
+      std::size_t space1=line.find(' ', 2);
+      if(space1==std::string::npos) return true;
+      std::size_t space2=line.find(' ', space1+1);
+      if(space2==std::string::npos) return true;
+
+      timet &t=time_map[line.substr(space2+1)];
+      t.total+=time_periodt(
+        strtoull(line.substr(2, space1-2).c_str(), NULL, 10));
+      t.last=time_periodt(
+        strtoull(line.substr(space1+1, space2-space1-1).c_str(), NULL, 10));
+    }
+    else
+      return true;
+  }
+  
+  return true; // truncated
+}
@@ -9,6 +9,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef DELTACHECK_STATISTICS_H
 #define DELTACHECK_STATISTICS_H
 
+#include <istream>
 #include <ostream>
 #include <string>
 #include <map>
@@ -44,6 +45,14 @@ public:
   
   void start(const std::string &what);
   void stop(const std::string &what);
+
+  // adds the numbers and times of another set of statistics
+  void merge(const statisticst &);
+
+  // a compact line-based encoding, for passing the
+  // statistics of a worker process back to the parent
+  void write(std::ostream &) const;
+  bool read(std::istream &);
 };
 
 #endif
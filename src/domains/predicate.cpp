@@ -24,12 +24,14 @@ Function: predicatet::get
 
 void predicatet::make_false()
 {
-  uuf.resize(state_vars.size());
+  uuf.clear();
+  classes=0;
+  grow(state_vars.size());
 
   for(unsigned v1=0; v1<state_vars.size(); v1++)
-    for(unsigned v2=0; v2<state_vars.size(); v2++)
+    for(unsigned v2=v1+1; v2<state_vars.size(); v2++)
       if(state_vars[v1].type()==state_vars[v2].type())
-        uuf.make_union(v1, v2);
+        make_union(v1, v2);
 }
 
 /*******************************************************************\
@@ -52,8 +54,9 @@ void predicatet::get(const solvert &solver)
   // data structure.
   for(unsigned v1=0; v1<state_vars.size(); v1++)
     for(unsigned v2=v1+1; v2<state_vars.size(); v2++)
-      if(solver.is_equal(state_vars[v1], state_vars[v2]))
-        uuf.make_union(v1, v2);
+      if(!uuf.same_set(v1, v2) &&
+         solver.is_equal(state_vars[v1], state_vars[v2]))
+        make_union(v1, v2);
 }
 #endif
   
@@ -182,22 +185,44 @@ bool predicatet::disjunction(const predicatet &other)
 
   assert(other.state_vars.size()==state_vars.size());
 
+  // Two variables remain equal iff they are equal in both.
+  // The classes of the result are thus the non-empty
+  // intersections of a class of 'this' and a class of 'other',
+  // which we find by bucketing each variable by its pair of
+  // representatives.
+
+  grow(state_vars.size());
+  const unsigned size=uuf.size();
+
   unsigned_union_find new_uuf;
-  new_uuf.resize(uuf.size());
+  new_uuf.resize(size);
+  unsigned new_classes=size;
+
+  typedef hash_map_cont<unsigned long long, unsigned> bucketst;
+  bucketst buckets;
+
+  for(unsigned v=0; v<size; v++)
+  {
+    unsigned long long key=
+      ((unsigned long long)uuf.find(v)<<32)|other.uuf.find(v);
+
+    std::pair<bucketst::iterator, bool> b=
+      buckets.insert(std::pair<unsigned long long, unsigned>(key, v));
+
+    if(!b.second)
+    {
+      new_uuf.make_union(b.first->second, v);
+      new_classes--;
+    }
+  }
+
+  // the result refines our partition, and is weaker
+  // iff it has more classes
+  assert(new_classes>=classes);
+  change=new_classes!=classes;
 
-  // can be done better than quadratic
-  for(unsigned v1=0; v1<state_vars.size(); v1++)
-    for(unsigned v2=0; v2<state_vars.size(); v2++)
-      if(v1!=v2 && uuf.same_set(v1, v2))
-      {
-        if(other.uuf.same_set(v1, v2)) // same true in 'other'?
-          new_uuf.make_union(v1, v2);
-        else
-          change=true; // things got weaker
-      }
-  
-  assert(uuf.size()==new_uuf.size());
   uuf.swap(new_uuf);
+  classes=new_classes;
 
   return change;
 }
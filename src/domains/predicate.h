@@ -13,6 +13,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/decision_procedure.h>
 #include <util/std_expr.h>
 #include <util/union_find.h>
+#include <util/hash_cont.h>
 #include <util/threeval.h>
 
 #include <analyses/interval_domain.h>
@@ -20,7 +21,7 @@ Author: Daniel Kroening, kroening@kroening.com
 struct predicatet
 {
 public:
-  predicatet()
+  predicatet():classes(0)
   {
   }
 
@@ -50,11 +51,8 @@ public:
 
   bool is_top() const
   {
-    for(unsigned i=0; i<uuf.size(); i++)
-      if(uuf.find(i)!=i)
-        return false;
-
-    return true;
+    // no two variables are known to be equal
+    return classes==uuf.size();
   }
   
   void get_constraints(std::vector<exprt> &) const;
@@ -66,6 +64,30 @@ protected:
 
   unsigned_union_find uuf;
 
+  // the number of equivalence classes in 'uuf'
+  unsigned classes;
+
+  inline void grow(unsigned size)
+  {
+    if(uuf.size()<size)
+    {
+      classes+=size-uuf.size();
+      uuf.resize(size);
+    }
+  }
+
+  inline void make_union(unsigned v1, unsigned v2)
+  {
+    grow(v1+1);
+    grow(v2+1);
+
+    if(!uuf.same_set(v1, v2))
+    {
+      uuf.make_union(v1, v2);
+      classes--;
+    }
+  }
+
   typedef expanding_vector<integer_intervalt> integer_intervalst;
   typedef expanding_vector<ieee_float_intervalt> ieee_float_intervalst;
   integer_intervalst integer_intervals;
@@ -32,52 +32,56 @@ void ssa_fixed_point(local_SSAt &SSA)
   if(SSA.goto_function.body.instructions.empty())
     return;
 
-  fixed_pointt fixed_point(SSA.ns);
+  // Add the fixed-points as constraints back into SSA.
+  // We simply use the last CFG node. It would be prettier to put
+  // these close to the loops.
+  goto_programt::const_targett last=
+    SSA.goto_function.body.instructions.end();
+  last--;
 
-  // get all backwards edges
-  
+  // One fixed point per loop, inner loops first, as their
+  // backwards gotos come first. The loops done so far are
+  // in the SSA by then.
   forall_goto_program_instructions(i_it, SSA.goto_function.body)
   {
-    if(i_it->is_backwards_goto())
+    if(!i_it->is_backwards_goto())
+      continue;
+
+    fixed_pointt fixed_point(SSA.ns);
+
+    // Record the objects modified by the loop to get
+    // 'primed' (post-state) and 'unprimed' (pre-state) variables.
+    // The others pass through the loop unchanged.
+    local_SSAt::objectst objects;
+    SSA.loop_objects(i_it, objects);
+
+    for(local_SSAt::objectst::const_iterator
+        o_it=objects.begin();
+        o_it!=objects.end();
+        o_it++)
     {
-      // Record the objects modified by the loop to get
-      // 'primed' (post-state) and 'unprimed' (pre-state) variables.
-      for(local_SSAt::objectst::const_iterator
-          o_it=SSA.ssa_objects.objects.begin();
-          o_it!=SSA.ssa_objects.objects.end();
-          o_it++)
-      {
-        symbol_exprt in=SSA.name(*o_it, local_SSAt::LOOP_BACK, i_it);
-        symbol_exprt out=SSA.read_rhs(*o_it, i_it);
+      symbol_exprt in=SSA.name(*o_it, local_SSAt::LOOP_BACK, i_it);
+      symbol_exprt out=SSA.read_rhs(*o_it, i_it);
+    
+      fixed_point.pre_state_vars.push_back(in);
+      fixed_point.post_state_vars.push_back(out);
+    }
+
+    {
+      ssa_objectt guard=SSA.guard_symbol();
+      symbol_exprt in=SSA.name(guard, local_SSAt::LOOP_BACK, i_it);
+      symbol_exprt out=SSA.name(guard, local_SSAt::OUT, i_it);
       
-        fixed_point.pre_state_vars.push_back(in);
-        fixed_point.post_state_vars.push_back(out);
-      }
-
-      {
-        ssa_objectt guard=SSA.guard_symbol();
-        symbol_exprt in=SSA.name(guard, local_SSAt::LOOP_BACK, i_it);
-        symbol_exprt out=SSA.name(guard, local_SSAt::OUT, i_it);
-        
-        fixed_point.pre_state_vars.push_back(in);
-        fixed_point.post_state_vars.push_back(out);
-      }
+      fixed_point.pre_state_vars.push_back(in);
+      fixed_point.post_state_vars.push_back(out);
     }
-  }
 
-  // transition relation
-  fixed_point.transition_relation << SSA;
+    // transition relation
+    fixed_point.transition_relation << SSA;
 
-  // kick off fixed-point computation
-  fixed_point();
-  
-  // Add fixed-point as constraints back into SSA.
-  // We simply use the last CFG node. It would be prettier to put
-  // these close to the loops.
-  goto_programt::const_targett loc=
-    SSA.goto_function.body.instructions.end();
-  loc--;
-  local_SSAt::nodet &node=SSA.nodes[loc];
+    // kick off fixed-point computation
+    fixed_point();
     
-  fixed_point.state_predicate.get_constraints(node.constraints);
+    fixed_point.state_predicate.get_constraints(SSA.nodes[last].constraints);
+  }
 }
@@ -0,0 +1,95 @@
+/*******************************************************************\
+
+Module: Delta Checking Solver
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#ifndef CPROVER_DELTACHECK_BACKTRACKING_UNION_FIND_H
+#define CPROVER_DELTACHECK_BACKTRACKING_UNION_FIND_H
+
+#include <cassert>
+#include <vector>
+
+// Union by size, but without path compression, which
+// makes it easy to undo the unions in reverse order.
+
+class backtracking_union_findt
+{
+public:
+  inline unsigned find(unsigned a) const
+  {
+    if(a>=nodes.size()) return a;
+    while(nodes[a].parent!=a) a=nodes[a].parent;
+    return a;
+  }
+
+  inline bool same_set(unsigned a, unsigned b) const
+  {
+    return find(a)==find(b);
+  }
+
+  // Merges the sets of 'a' and 'b', which must differ.
+  // Returns the root that is no longer a root.
+  unsigned make_union(unsigned a, unsigned b)
+  {
+    check_index(a);
+    check_index(b);
+
+    a=find(a);
+    b=find(b);
+    assert(a!=b);
+
+    // the smaller one goes below the larger one
+    if(nodes[a].count<nodes[b].count)
+      std::swap(a, b);
+
+    nodes[b].parent=a;
+    nodes[a].count+=nodes[b].count;
+
+    return b;
+  }
+
+  // Undoes the union that made 'child' a non-root;
+  // the unions done later must have been undone.
+  void undo_union(unsigned child)
+  {
+    unsigned root=nodes[child].parent;
+    assert(root!=child && nodes[root].parent==root);
+    nodes[root].count-=nodes[child].count;
+    nodes[child].parent=child;
+  }
+
+  inline unsigned size() const
+  {
+    return nodes.size();
+  }
+
+  // number of elements in the set of 'a'
+  inline unsigned count(unsigned a) const
+  {
+    if(a>=nodes.size()) return 1;
+    return nodes[find(a)].count;
+  }
+
+  void check_index(unsigned a)
+  {
+    while(a>=nodes.size())
+      nodes.push_back(nodet(nodes.size()));
+  }
+
+protected:
+  struct nodet
+  {
+    unsigned parent, count;
+
+    explicit inline nodet(unsigned nr):parent(nr), count(1)
+    {
+    }
+  };
+
+  std::vector<nodet> nodes;
+};
+
+#endif
@@ -29,14 +29,18 @@ Function: fixed_pointt::operator()
 
 void fixed_pointt::operator()()
 {
-  iteration_number=0;
+  initialize();
   
-  // Set up the state predicate, starting with 'false'
-  // (the empty set).
+  // The transition relation doesn't change, and thus,
+  // we give it to the solver only once.
+  solvert solver(ns);
+
+  for(constraintst::const_iterator
+      it=transition_relation.begin();
+      it!=transition_relation.end();
+      it++)
+    solver << *it;
 
-  state_predicate.state_vars=pre_state_vars;
-  state_predicate.make_false();
-  
   bool change;
 
   do
@@ -49,10 +53,13 @@ void fixed_pointt::operator()()
               << iteration_number << "\n";
     #endif
    
-    change=iteration();
+    change=iteration(solver);
   }
   while(change);
 
+  if(widened)
+    narrowing(solver);
+
   #ifdef DEBUG
   std::cout << "Fixed-point after " << iteration_number
             << " iteration(s)\n";
@@ -62,7 +69,52 @@ void fixed_pointt::operator()()
 
 /*******************************************************************\
 
-Function: fixed_pointt::iteration
+Function: fixed_pointt::initialize
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void fixed_pointt::initialize()
+{
+  iteration_number=0;
+  widened=false;
+  
+  // Set up the state predicate, starting with 'false'
+  // (the empty set).
+
+  state_predicate.state_vars=pre_state_vars;
+  state_predicate.make_false();
+}
+
+/*******************************************************************\
+
+Function: fixed_pointt::initialize
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void fixed_pointt::initialize(const predicatet &candidate)
+{
+  iteration_number=0;
+  widened=false;
+
+  state_predicate=candidate;
+  state_predicate.rename(pre_state_vars);
+}
+
+/*******************************************************************\
+
+Function: fixed_pointt::step
 
   Inputs:
 
@@ -72,27 +124,162 @@ Function: fixed_pointt::iteration
 
 \*******************************************************************/
 
-bool fixed_pointt::iteration()
+bool fixed_pointt::step()
 {
+  iteration_number++;
+
+  #ifdef DEBUG
+  std::cout << "\n"
+            << "******** Forward least fixed-point step #"
+            << iteration_number << "\n";
+  #endif
+
   solvert solver(ns);
+  solver << transition_relation;
 
-  // Feed transition relation into solver.
-  for(constraintst::const_iterator
-      it=transition_relation.begin();
-      it!=transition_relation.end();
-      it++)
-    solver << *it;
+  return iteration(solver);
+}
+
+/*******************************************************************\
+
+Function: fixed_pointt::narrow
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: for step(), once stable
+
+\*******************************************************************/
+
+void fixed_pointt::narrow()
+{
+  if(!widened) return;
+
+  solvert solver(ns);
+  solver << transition_relation;
+
+  narrowing(solver);
+}
+
+/*******************************************************************\
+
+Function: fixed_pointt::check
+
+  Inputs:
+
+ Outputs: 'true' if the given state predicate is a fixed point
+
+ Purpose:
+
+\*******************************************************************/
+
+bool fixed_pointt::check(const predicatet &candidate)
+{
+  initialize(candidate);
+  return !step();
+}
+
+/*******************************************************************\
+
+Function: fixed_pointt::iteration
+
+  Inputs:
+
+ Outputs: 'true' if there is a change in the state predicate
+
+ Purpose:
+
+\*******************************************************************/
+
+bool fixed_pointt::iteration(solvert &solver)
+{
+  predicatet post_state;
+  get_post_state(solver, post_state);
+
+  if(iteration_number>widening_delay)
+  {
+    bool change=state_predicate.widen(post_state);
+    if(change) widened=true;
+    return change;
+  }
+    
+  // Form disjunction of previous state predicate and the new one.
+  return state_predicate.disjunction(post_state);
+}
+
+/*******************************************************************\
+
+Function: fixed_pointt::narrowing
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: The state predicate is stable, and thus, the post
+          state implies it. The post state is then stable as
+          well, and we take it instead.
+
+\*******************************************************************/
+
+void fixed_pointt::narrowing(solvert &solver)
+{
+  iteration_number++;
+
+  #ifdef DEBUG
+  std::cout << "\n"
+            << "******** Narrowing iteration #"
+            << iteration_number << "\n";
+  #endif
+
+  predicatet post_state;
+  get_post_state(solver, post_state);
+
+  predicatet widened_predicate=state_predicate;
+  state_predicate=post_state;
+
+  // The solver is incomplete, and thus, we check that the
+  // post state is indeed stable, and otherwise keep the
+  // widened state predicate.
+  get_post_state(solver, post_state);
+
+  if(state_predicate.disjunction(post_state))
+    state_predicate=widened_predicate;
+}
+
+/*******************************************************************\
+
+Function: fixed_pointt::get_post_state
+
+  Inputs:
+
+ Outputs: the post state, renamed to the pre-state variables
+
+ Purpose:
+
+\*******************************************************************/
+
+void fixed_pointt::get_post_state(
+  solvert &solver,
+  predicatet &post_state)
+{
+  // The current state predicate only holds
+  // for this iteration.
+  solver.push();
 
   // Feed current state predicate into solver.
   state_predicate.set_to_true(solver);
   
+  if(state_predicate.is_bottom() && back_edge.is_not_nil())
+    solver.set_to_false(back_edge);
+  
   #ifdef DEBUG
   std::cout << "Entry state:\n";
   output(std::cout);
   #endif
 
   // solve
-  solver.dec_solve();
+  decision_proceduret::resultt result=solver.dec_solve();
  
   #ifdef DEBUG
   std::cout << "=======================\n";
@@ -101,10 +288,14 @@ bool fixed_pointt::iteration()
   #endif
 
   // now get new post-state
-  predicatet post_state;
   post_state.state_vars=post_state_vars;
   
-  post_state.get(solver);
+  if(result==decision_proceduret::D_UNSATISFIABLE)
+    post_state.make_false();
+  else
+    post_state.get(solver);
+  
+  solver.pop();
 
   #ifdef DEBUG
   std::cout << "Post state:\n";
@@ -114,9 +305,6 @@ bool fixed_pointt::iteration()
   // Now 'OR' with previous state predicate.
   // First rename post-state to pre-state.
   post_state.rename(pre_state_vars);
-    
-  // Form disjunction of previous state predicate and the new one.
-  return state_predicate.disjunction(post_state);
 }
 
 /*******************************************************************\
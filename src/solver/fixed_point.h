@@ -15,7 +15,11 @@ Author: Daniel Kroening, kroening@kroening.com
 class fixed_pointt
 {
 public:
-  explicit fixed_pointt(const namespacet &_ns):ns(_ns)
+  explicit fixed_pointt(const namespacet &_ns):
+    back_edge(nil_exprt()),
+    widening_delay(10),
+    widened(false),
+    ns(_ns)
   {
   }  
 
@@ -25,19 +29,47 @@ public:
   predicatet::state_var_listt pre_state_vars, post_state_vars;
   
   predicatet state_predicate;
+  
+  // The condition for taking the back edge, if known. The post
+  // state of 'false' is then the one of the entry edge alone.
+  exprt back_edge;
 
   void output(std::ostream &) const;
   
   unsigned iteration_number;
 
+  // Any iteration after the first 'widening_delay' ones drops
+  // the bounds it would weaken, instead of moving them, which
+  // bounds the number of further iterations. Once stable, a
+  // narrowing iteration, without join, brings back some of
+  // what the widening lost.
+  unsigned widening_delay;
+  bool widened;
+
   void operator()();
 
+  // For iteration strategies that change the transition
+  // relation between iterations: start from 'false', and
+  // do one iteration with the current transition relation.
+  // step() returns 'true' if the state predicate changed.
+  void initialize();
+  bool step();
+  void narrow();
+
+  // Starts from the given state predicate instead of 'false'.
+  // check() then does one iteration, and returns 'true' if the
+  // state predicate didn't change, i.e., if it is a fixed
+  // point; otherwise, we need to start over.
+  void initialize(const predicatet &);
+  bool check(const predicatet &);
+
 protected:
   const namespacet &ns;
 
   // fixed-point iteration
-  void initialize();
-  bool iteration();
+  bool iteration(solvert &);
+  void narrowing(solvert &);
+  void get_post_state(solvert &, predicatet &dest);
 };
 
 static inline decision_proceduret & operator << (
@@ -6,6 +6,8 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <util/arith_tools.h>
+
 #include <langapi/language_util.h>
 
 #include "predicate.h"
@@ -24,12 +26,66 @@ Function: predicatet::get
 
 void predicatet::make_false()
 {
-  uuf.resize(state_vars.size());
+  uuf.clear();
+  classes=0;
+  grow(state_vars.size());
+  integer_intervals.clear();
+  bottom=true;
 
   for(unsigned v1=0; v1<state_vars.size(); v1++)
-    for(unsigned v2=0; v2<state_vars.size(); v2++)
+    for(unsigned v2=v1+1; v2<state_vars.size(); v2++)
       if(state_vars[v1].type()==state_vars[v2].type())
-        uuf.make_union(v1, v2);
+        make_union(v1, v2);
+}
+
+/*******************************************************************\
+
+Function: predicatet::make_top
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void predicatet::make_top()
+{
+  uuf.clear();
+  classes=0;
+  grow(state_vars.size());
+  integer_intervals.clear();
+  bottom=false;
+}
+
+/*******************************************************************\
+
+Function: predicatet::is_top
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool predicatet::is_top() const
+{
+  if(bottom) return false;
+
+  // no two variables are known to be equal
+  if(classes!=uuf.size()) return false;
+  
+  // and there are no bounds
+  for(integer_intervalst::const_iterator
+      i_it=integer_intervals.begin();
+      i_it!=integer_intervals.end(); i_it++)
+    if(!i_it->is_top())
+      return false;
+
+  return true;
 }
 
 /*******************************************************************\
@@ -51,8 +107,19 @@ void predicatet::get(const solvert &solver)
   // data structure.
   for(unsigned v1=0; v1<state_vars.size(); v1++)
     for(unsigned v2=v1+1; v2<state_vars.size(); v2++)
-      if(solver.is_equal(state_vars[v1], state_vars[v2]))
-        uuf.make_union(v1, v2);
+      if(!uuf.same_set(v1, v2) &&
+         solver.is_equal(state_vars[v1], state_vars[v2]))
+        make_union(v1, v2);
+
+  // the intervals of the integer variables
+  for(unsigned v=0; v<state_vars.size(); v++)
+  {
+    const irep_idt &type_id=state_vars[v].type().id();
+    if(type_id==ID_signedbv || type_id==ID_unsignedbv)
+      integer_intervals[v]=solver.get_integer_interval(state_vars[v]);
+  }
+  
+  bottom=false;
 }
   
 /*******************************************************************\
@@ -69,13 +136,99 @@ Function: predicatet::set_to_true
 
 void predicatet::set_to_true(decision_proceduret &dest) const
 {
-  // pass equalities to solver
-    
+  // pass equalities and bounds to solver
+  std::list<exprt> constraints;
+  get_constraints(constraints);
+
+  for(std::list<exprt>::const_iterator
+      c_it=constraints.begin(); c_it!=constraints.end(); c_it++)
+    dest.set_to_true(*c_it);
+}
+
+/*******************************************************************\
+
+Function: predicatet::get_constraints
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void predicatet::get_constraints(std::list<exprt> &dest) const
+{
   for(unsigned v=0; v<state_vars.size(); v++)
   {
     unsigned eq=uuf.find(v);
-    if(eq!=v) dest.set_to_true(equal_exprt(state_vars[v], state_vars[eq]));
+    if(eq!=v) dest.push_back(equal_exprt(state_vars[v], state_vars[eq]));
   }
+  
+  if(bottom) return;
+
+  for(integer_intervalst::const_iterator
+      i_it=integer_intervals.begin();
+      i_it!=integer_intervals.end(); i_it++)
+  {
+    const symbol_exprt &var=state_vars[i_it-integer_intervals.begin()];
+
+    if(i_it->lower_set)
+      dest.push_back(binary_relation_exprt(
+        from_integer(i_it->lower, var.type()), ID_le, var));
+
+    if(i_it->upper_set)
+      dest.push_back(binary_relation_exprt(
+        var, ID_le, from_integer(i_it->upper, var.type())));
+  }
+}
+
+/*******************************************************************\
+
+Function: predicatet::get_classes
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void predicatet::get_classes(std::vector<unsigned> &dest) const
+{
+  dest.resize(state_vars.size());
+
+  for(unsigned v=0; v<state_vars.size(); v++)
+    dest[v]=uuf.find(v);
+}
+
+/*******************************************************************\
+
+Function: predicatet::set_classes
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void predicatet::set_classes(const std::vector<unsigned> &src)
+{
+  assert(src.size()==state_vars.size());
+
+  uuf.clear();
+  classes=0;
+  grow(state_vars.size());
+  integer_intervals.clear();
+  bottom=false;
+
+  for(unsigned v=0; v<src.size(); v++)
+    if(src[v]<state_vars.size() &&
+       state_vars[v].type()==state_vars[src[v]].type())
+      make_union(v, src[v]);
 }
 
 /*******************************************************************\
@@ -117,24 +270,28 @@ void predicatet::output(std::ostream &out) const
   }
   
   // print intervals
-  #if 0
+  if(bottom)
+  {
+    out << "False\n";
+    return;
+  }
+
   for(integer_intervalst::const_iterator
-      i_it=integer_intervals.begin(); i_it!=integer_intervals.end(); i_it++)
+      i_it=integer_intervals.begin();
+      i_it!=integer_intervals.end(); i_it++)
   {
-    if(i_it->lower_is_set || i_it->upper_is_set)
-    {
-      if(i_it->lower_is_set)
-        out << from_expr(i_it->lower) << " <= ";
-        
-      out << from_expr(vars[i_it-intervals.begin()]);
-        
-      if(i_it->upper_is_set)
-        out << " <= " << from_expr(i_it->lower);
-        
-      out << "\n";
-    }
+    if(i_it->is_top()) continue;
+  
+    if(i_it->lower_set)
+      out << i_it->lower << " <= ";
+      
+    out << from_expr(state_vars[i_it-integer_intervals.begin()]);
+      
+    if(i_it->upper_set)
+      out << " <= " << i_it->upper;
+      
+    out << "\n";
   }
-  #endif
 }
 
 /*******************************************************************\
@@ -143,7 +300,7 @@ Function: predicatet::disjunction
 
   Inputs:
 
- Outputs:
+ Outputs: 'true' iff predicate is weakened
 
  Purpose:
 
@@ -151,30 +308,159 @@ Function: predicatet::disjunction
 
 bool predicatet::disjunction(const predicatet &other)
 {
-  bool change=false;
+  bool change=join_equalities(other);
+
+  if(join_intervals(other, false))
+    change=true;
+
+  return change;
+}
+
+/*******************************************************************\
+
+Function: predicatet::widen
+
+  Inputs:
 
-  //
-  // do equalities
-  //
+ Outputs: 'true' iff predicate is weakened
 
+ Purpose: The equalities have finite height, and we join them as
+          usual. The bounds of a counter may move by one in each
+          iteration, and thus, we drop the bounds the join would
+          weaken instead.
+
+\*******************************************************************/
+
+bool predicatet::widen(const predicatet &other)
+{
+  bool change=join_equalities(other);
+
+  if(join_intervals(other, true))
+    change=true;
+
+  return change;
+}
+
+/*******************************************************************\
+
+Function: predicatet::join_equalities
+
+  Inputs:
+
+ Outputs: 'true' iff the equalities are weakened
+
+ Purpose:
+
+\*******************************************************************/
+
+bool predicatet::join_equalities(const predicatet &other)
+{
   assert(other.state_vars.size()==state_vars.size());
 
+  // Two variables remain equal iff they are equal in both.
+  // The classes of the result are thus the non-empty
+  // intersections of a class of 'this' and a class of 'other',
+  // which we find by bucketing each variable by its pair of
+  // representatives.
+
+  grow(state_vars.size());
+  const unsigned size=uuf.size();
+
   unsigned_union_find new_uuf;
-  new_uuf.resize(uuf.size());
+  new_uuf.resize(size);
+  unsigned new_classes=size;
+
+  typedef hash_map_cont<unsigned long long, unsigned> bucketst;
+  bucketst buckets;
+
+  for(unsigned v=0; v<size; v++)
+  {
+    unsigned long long key=
+      ((unsigned long long)uuf.find(v)<<32)|other.uuf.find(v);
+
+    std::pair<bucketst::iterator, bool> b=
+      buckets.insert(std::pair<unsigned long long, unsigned>(key, v));
+
+    if(!b.second)
+    {
+      new_uuf.make_union(b.first->second, v);
+      new_classes--;
+    }
+  }
+
+  // the result refines our partition, and is weaker
+  // iff it has more classes
+  assert(new_classes>=classes);
+  bool change=new_classes!=classes;
 
-  // can be done better than quadratic
-  for(unsigned v1=0; v1<state_vars.size(); v1++)
-    for(unsigned v2=0; v2<state_vars.size(); v2++)
-      if(v1!=v2 && uuf.same_set(v1, v2))
-      {
-        if(other.uuf.same_set(v1, v2)) // same true in 'other'?
-          new_uuf.make_union(v1, v2);
-        else
-          change=true; // things got weaker
-      }
-  
-  assert(uuf.size()==new_uuf.size());
   uuf.swap(new_uuf);
+  classes=new_classes;
+
+  return change;
+}
+
+/*******************************************************************\
+
+Function: predicatet::join_intervals
+
+  Inputs:
+
+ Outputs: 'true' iff an interval is weakened
+
+ Purpose: The hull of the intervals; when widening, a bound that
+          would be weakened is dropped instead.
+
+\*******************************************************************/
+
+bool predicatet::join_intervals(const predicatet &other, bool widen)
+{
+  if(other.bottom)
+    return false;
+
+  if(bottom)
+  {
+    // Leaving 'false' is a change even if there are no
+    // bounds: the post state of 'false' doesn't take the
+    // back edge.
+    integer_intervals=other.integer_intervals;
+    bottom=false;
+    return true;
+  }
+
+  bool change=false;
+
+  for(unsigned v=0; v<integer_intervals.size(); v++)
+  {
+    integer_intervalt &interval=integer_intervals[v];
+
+    if(interval.is_top()) continue;
+    
+    integer_intervalt other_interval;
+    if(v<other.integer_intervals.size())
+      other_interval=other.integer_intervals.at(v);
+
+    if(interval.lower_set &&
+       (!other_interval.lower_set || other_interval.lower<interval.lower))
+    {
+      if(other_interval.lower_set && !widen)
+        interval.lower=other_interval.lower;
+      else
+        interval.lower_set=false;
+
+      change=true;
+    }
+
+    if(interval.upper_set &&
+       (!other_interval.upper_set || other_interval.upper>interval.upper))
+    {
+      if(other_interval.upper_set && !widen)
+        interval.upper=other_interval.upper;
+      else
+        interval.upper_set=false;
+
+      change=true;
+    }
+  }
 
   return change;
 }
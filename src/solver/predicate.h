@@ -9,8 +9,11 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_DELTACHECK_PREDICATE_H
 #define CPROVER_DELTACHECK_PREDICATE_H
 
+#include <list>
+
 #include <util/std_expr.h>
 #include <util/union_find.h>
+#include <util/hash_cont.h>
 #include <util/threeval.h>
 
 #include "solver.h"
@@ -18,7 +21,7 @@ Author: Daniel Kroening, kroening@kroening.com
 struct predicatet
 {
 public:
-  predicatet()
+  predicatet():classes(0), bottom(false)
   {
   }
 
@@ -28,9 +31,13 @@ public:
 
   void output(std::ostream &) const;
   void make_false();
+  void make_top();
   
   // returns 'true' iff predicate is weakened
   bool disjunction(const predicatet &);
+
+  // as above, but drops the bounds that are weakened
+  bool widen(const predicatet &);
   
   // rename supporting set of variables
   void rename(const state_var_listt &new_state_vars);
@@ -41,31 +48,67 @@ public:
   // push the predicate to a solver as constraint
   void set_to_true(decision_proceduret &) const;
 
+  // the predicate as constraints
+  void get_constraints(std::list<exprt> &) const;
+
+  // The equalities as the number of a representative for each
+  // state variable, say for keeping the predicate in a file.
+  // set_classes ignores the equalities between variables of
+  // different types.
+  void get_classes(std::vector<unsigned> &) const;
+  void set_classes(const std::vector<unsigned> &);
+
   bool is_bottom() const
   {
-    return false;
+    return bottom;
   }
 
-  bool is_top() const
-  {
-    for(unsigned i=0; i<uuf.size(); i++)
-      if(uuf.find(i)!=i)
-        return false;
-
-    return true;
-  }
+  bool is_top() const;
 
 protected:
   // for now, we can track:
   // * equalities between variables
-  // * intervals
+  // * intervals of integer variables
 
   unsigned_union_find uuf;
 
+  // the number of equivalence classes in 'uuf'
+  unsigned classes;
+
+  inline void grow(unsigned size)
+  {
+    if(uuf.size()<size)
+    {
+      classes+=size-uuf.size();
+      uuf.resize(size);
+    }
+  }
+
+  inline void make_union(unsigned v1, unsigned v2)
+  {
+    grow(v1+1);
+    grow(v2+1);
+
+    if(!uuf.same_set(v1, v2))
+    {
+      uuf.make_union(v1, v2);
+      classes--;
+    }
+  }
+
+  bool join_equalities(const predicatet &);
+  
   typedef expanding_vector<integer_intervalt> integer_intervalst;
   typedef expanding_vector<ieee_float_intervalt> ieee_float_intervalst;
   integer_intervalst integer_intervals;
   ieee_float_intervalst ieee_float_intervals;
+  
+  bool join_intervals(const predicatet &, bool widen);
+  
+  // 'false', i.e., the empty set; the equalities are then
+  // the ones between all variables of the same type, and
+  // there are no intervals
+  bool bottom;
 };
 
 static inline std::ostream & operator << (
@@ -12,6 +12,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <iostream>
 #endif
 
+#include <algorithm>
 #include <map>
 #include <set>
 
@@ -36,7 +37,10 @@ Function: solvert::solvert
 
 \*******************************************************************/
 
-solvert::solvert(const namespacet &_ns):decision_proceduret(_ns)
+solvert::solvert(const namespacet &_ns):
+  decision_proceduret(_ns),
+  conflict(false),
+  arithmetic_budget(0)
 {
   false_nr=add(false_exprt());
   true_nr=add(true_exprt());
@@ -100,139 +104,983 @@ unsigned solvert::add_rec(const exprt &expr)
   unsigned nr=expr_numbering(expr);
   
   // new? do recursion
-  if(expr_numbering.size()!=old_size) new_expression(nr);
+  if(expr_numbering.size()!=old_size)
+  {
+    // a class of its own for now
+    expr_map[nr].members.push_back(nr);
+    new_expression(nr);
+  }
 
   return nr;
 }
 
 /*******************************************************************\
 
-Function: solvert::is_equal
+Function: solvert::is_equal
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool solvert::is_equal(const exprt &a, const exprt &b) const
+{
+  exprt tmp_a=a, tmp_b=b;
+  
+  simplify(tmp_a, ns);
+  simplify(tmp_b, ns);
+  
+  numbering<exprt>::number_type a_nr, b_nr;
+  if(expr_numbering.get_number(tmp_a, a_nr)) return false;
+  if(expr_numbering.get_number(tmp_b, b_nr)) return false;
+  return is_equal(a_nr, b_nr);
+}
+
+/*******************************************************************\
+
+Function: solvert::get_integer_interval
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+integer_intervalt solvert::get_integer_interval(const exprt &expr) const
+{
+  exprt tmp=expr;
+  simplify(tmp, ns);
+
+  numbering<exprt>::number_type nr;
+  if(expr_numbering.get_number(tmp, nr))
+    return integer_intervalt();
+    
+  unsigned root=equalities.find(nr);
+  if(root>=integer_intervals.size())
+    return integer_intervalt();
+
+  return integer_intervals.at(root);
+}
+
+/*******************************************************************\
+
+Function: solvert::trusts
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool solvert::trusts(const exprt &expr)
+{
+  const irep_idt &id=expr.id();
+
+  if(id==ID_constant)
+    return expr.type().id()!=ID_floatbv;
+
+  if((id==ID_le || id==ID_lt || id==ID_ge || id==ID_gt) &&
+     expr.operands().size()==2 &&
+     expr.op0().type().id()==ID_floatbv)
+    return false;
+
+  forall_operands(it, expr)
+    if(!trusts(*it))
+      return false;
+
+  return true;
+}
+
+/*******************************************************************\
+
+Function: solvert::add_operands
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void solvert::add_operands(unsigned nr)
+{
+  // expr_numbering is a vector, and thus not stable.
+  // We will call add recursively below.
+  const exprt expr=expr_numbering[nr];
+
+  const exprt::operandst &expr_op=expr.operands();
+  std::vector<unsigned> dest;
+
+  dest.resize(expr_op.size());
+
+  for(unsigned i=0; i<dest.size(); i++)
+    dest[i]=add_rec(expr_op[i]);
+
+  exprt head=expr;
+  head.operands().clear();
+
+  // store    
+  expr_map[nr].op=dest;
+  expr_map[nr].head=head_numbering(head);
+
+  // Remember that the operands are contained in the expresion.
+  for(unsigned i=0; i<dest.size(); i++)
+    expr_map[dest[i]].operand_of.push_back(nr);
+}
+
+/*******************************************************************\
+
+Function: solvert::new_expression
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void solvert::new_expression(unsigned nr)
+{
+  // expr_numbering is a vector, and thus not stable.
+  const exprt expr=expr_numbering[nr];
+      
+  if(expr.id()==ID_if)
+  {
+    add_operands(nr);
+  }
+  else if(expr.id()==ID_or ||
+          expr.id()==ID_and ||
+          expr.id()==ID_not)
+  {
+    add_operands(nr);
+  }
+  else if(expr.id()==ID_notequal)
+  {
+    // we record x!=y <=> !x==y, see below
+    add_rec(not_exprt(equal_exprt(expr.op0(), expr.op1())));
+  }
+  else if(expr.id()==ID_equal)
+  {
+    add_operands(nr);
+  }
+  else if(expr.id()==ID_address_of)
+  {
+    // NOT an uninterpreted function, but rather a constant.
+  }
+  else
+  {
+    if(expr.has_operands()) // make it uninterpreted
+    {
+      add_operands(nr);
+      
+      #ifdef DEBUG
+      std::cout << "UF " << nr << " added: " << expr.id();
+      forall_operands(it, expr) std::cout << " " << add(*it);
+      std::cout << "\n";
+      #endif
+    }
+  }
+  
+  expression_facts(nr);
+}
+
+/*******************************************************************\
+
+Function: solvert::expression_facts
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the facts that hold for an expression by itself
+
+\*******************************************************************/
+
+void solvert::expression_facts(unsigned nr)
+{
+  // expr_numbering is a vector, and thus not stable.
+  const exprt expr=expr_numbering[nr];
+  
+  // the rules for it need to be looked at
+  enqueue(nr);
+  
+  // add bounds around constants
+  if(expr.is_constant())
+  {
+    bound(to_constant_expr(expr), nr, WEAK, LOWER);
+    bound(to_constant_expr(expr), nr, WEAK, UPPER);
+  }
+  
+  // we record x!=y <=> !x==y
+  if(expr.id()==ID_notequal)
+    set_equal(add_rec(not_exprt(equal_exprt(expr.op0(), expr.op1()))), nr);
+}
+
+/*******************************************************************\
+
+Function: solvert::set_equal
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void solvert::set_equal(unsigned a, unsigned b)
+{
+  unsigned root_a=equalities.find(a), root_b=equalities.find(b);
+
+  if(root_a==root_b) return; // nothing new
+
+  // Does this make one of the classes true or false?
+  // If so, its members and their users are triggered.
+  unsigned root_true=equalities.find(true_nr);
+  unsigned root_false=equalities.find(false_nr);
+
+  bool bool_a=root_a==root_true || root_a==root_false;
+  bool bool_b=root_b==root_true || root_b==root_false;
+
+  if(bool_a && !bool_b)
+    enqueue_class(root_b, true);
+  else if(bool_b && !bool_a)
+    enqueue_class(root_a, true);
+  else if(bool_a && bool_b)
+    set_conflict(); // true==false
+
+  unsigned other=equalities.make_union(root_a, root_b);
+  unsigned root=other==root_a?root_b:root_a;
+
+  if(recording())
+    trail.push_back(trail_entryt(trail_entryt::UNION, other));
+
+  // The expressions that have a member of the class that loses
+  // its root as operand are triggered. They need a new signature,
+  // and this catches all expressions that have operands in both
+  // classes. The union is weighted, and thus, this is the smaller
+  // class.
+  enqueue_class(other, false);
+
+  // The disequalities of the class that loses its root move over.
+  // The equalities between the members of the other class and
+  // a class that is disequal to it are caught above; the ones
+  // between the members of the root class and such a class are
+  // triggered here. The list of the other class stays as it is,
+  // for pop().
+  const std::vector<unsigned> &other_disequal_to=
+    expr_map[other].disequal_to;
+
+  for(unsigned i=0; i<other_disequal_to.size(); i++)
+  {
+    unsigned d_root=equalities.find(other_disequal_to[i]);
+
+    if(d_root==root)
+      set_conflict(); // a class can't be disequal to itself
+    else if(add_disequality(root, d_root))
+    {
+      if(expr_map[d_root].members.size()<expr_map[root].members.size())
+        enqueue_class(d_root, false);
+      else
+        enqueue_class(root, false);
+    }
+  }
+
+  // Copy the members over. The root has the larger class.
+  // pop() undoes this by cutting off the members of the
+  // other class, and thus, we keep these there.
+  std::vector<unsigned> &root_members=expr_map[root].members;
+  std::vector<unsigned> &other_members=expr_map[other].members;
+
+  root_members.insert(
+    root_members.end(), other_members.begin(), other_members.end());
+
+  if(!recording())
+  {
+    std::vector<unsigned>().swap(other_members);
+    std::vector<unsigned>().swap(expr_map[other].disequal_to);
+  }
+
+  // Intervals are kept for the roots only. The users
+  // of the class have been triggered above.
+  integer_intervalt integer_interval=integer_intervals[other];
+  meet_integer_interval(root, integer_interval);
+
+  ieee_float_intervalt ieee_float_interval=ieee_float_intervals[other];
+  meet_ieee_float_interval(root, ieee_float_interval);
+
+  #ifdef DEBUG
+  std::cout << "MERGE " << a << " " << b << " -> " << root << "\n";
+  #endif
+}
+
+/*******************************************************************\
+
+Function: solvert::set_disequal
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void solvert::set_disequal(unsigned a, unsigned b)
+{
+  unsigned root_a=equalities.find(a), root_b=equalities.find(b);
+
+  if(root_a==root_b)
+  {
+    set_conflict(); // a class can't be disequal to itself
+    return;
+  }
+
+  if(!add_disequality(root_a, root_b))
+    return; // nothing new
+
+  // The equalities between the two classes are now false;
+  // these have operands in both classes.
+  if(expr_map[root_a].members.size()<expr_map[root_b].members.size())
+    enqueue_class(root_a, false);
+  else
+    enqueue_class(root_b, false);
+}
+
+/*******************************************************************\
+
+Function: solvert::add_disequality
+
+  Inputs:
+
+ Outputs: true if the disequality is new
+
+ Purpose:
+
+\*******************************************************************/
+
+bool solvert::add_disequality(unsigned root_a, unsigned root_b)
+{
+  root_pairt pair(std::min(root_a, root_b), std::max(root_a, root_b));
+
+  if(!disequalities.insert(pair).second)
+    return false;
+
+  expr_map[root_a].disequal_to.push_back(root_b);
+  expr_map[root_b].disequal_to.push_back(root_a);
+
+  if(recording())
+    trail.push_back(
+      trail_entryt(trail_entryt::DISEQUALITY, root_a, root_b));
+
+  return true;
+}
+
+/*******************************************************************\
+
+Function: solvert::set_conflict
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void solvert::set_conflict()
+{
+  if(conflict) return;
+
+  conflict=true;
+
+  if(recording())
+    trail.push_back(trail_entryt(trail_entryt::CONFLICT, 0));
+}
+
+/*******************************************************************\
+
+Function: solvert::meet_integer_interval
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool solvert::meet_integer_interval(
+  unsigned root,
+  const integer_intervalt &interval)
+{
+  integer_intervalt old_interval=integer_intervals[root];
+
+  if(!integer_intervals[root].meet(interval))
+    return false; // no change
+
+  if(recording())
+  {
+    trail.push_back(trail_entryt(trail_entryt::INTEGER_INTERVAL, root));
+    integer_interval_trail.push_back(old_interval);
+  }
+
+  if(integer_intervals[root].is_bottom())
+    set_conflict();
+  
+  // the arithmetic over the class needs to be looked at again
+  enqueue_class(root, false);
+
+  return true;
+}
+
+/*******************************************************************\
+
+Function: solvert::meet_ieee_float_interval
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void solvert::meet_ieee_float_interval(
+  unsigned root,
+  const ieee_float_intervalt &interval)
+{
+  ieee_float_intervalt old_interval=ieee_float_intervals[root];
+
+  if(!ieee_float_intervals[root].meet(interval))
+    return; // no change
+
+  if(recording())
+  {
+    trail.push_back(trail_entryt(trail_entryt::IEEE_FLOAT_INTERVAL, root));
+    ieee_float_interval_trail.push_back(old_interval);
+  }
+
+  if(ieee_float_intervals[root].is_bottom())
+    set_conflict();
+}
+
+/*******************************************************************\
+
+Function: solvert::enqueue_class
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void solvert::enqueue_class(unsigned root, bool members)
+{
+  const std::vector<unsigned> &class_members=expr_map[root].members;
+
+  for(std::vector<unsigned>::const_iterator
+      m_it=class_members.begin();
+      m_it!=class_members.end();
+      m_it++)
+  {
+    if(members) enqueue(*m_it);
+
+    const std::vector<unsigned> &operand_of=expr_map[*m_it].operand_of;
+
+    for(std::vector<unsigned>::const_iterator
+        o_it=operand_of.begin();
+        o_it!=operand_of.end();
+        o_it++)
+      enqueue(*o_it);
+  }
+}
+
+/*******************************************************************\
+
+Function: solvert::process_predicate
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the expression has become true or false
+
+\*******************************************************************/
+
+void solvert::process_predicate(unsigned nr, bool value)
+{
+  solver_exprt &se=expr_map[nr];
+
+  // remember we have done it
+  se.predicate_processed=true;
+
+  if(recording())
+    trail.push_back(trail_entryt(trail_entryt::PREDICATE_PROCESSED, nr));
+
+  // we don't add any expressions below, and thus,
+  // the references are stable
+  const exprt &expr=expr_numbering[nr];
+  const std::vector<unsigned> &op=se.op;
+
+  #ifdef DEBUG
+  std::cout << "PREDICATE " << (value?"true":"false") << ": "
+            << from_expr(ns, "", expr) << std::endl;
+  #endif
+
+  if(expr.id()==ID_equal)
+  {
+    assert(op.size()==2);
+
+    if(value)
+      set_equal(op[0], op[1]);
+    else
+      set_disequal(op[0], op[1]);
+  }
+  else if(expr.id()==ID_le)
+  {
+    assert(op.size()==2);
+
+    if(value)
+    {
+      if(expr.op0().is_constant()) // c <= something
+        bound(to_constant_expr(expr.op0()), op[1], WEAK, LOWER);
+      else if(expr.op1().is_constant()) // something <= c
+        bound(to_constant_expr(expr.op1()), op[0], WEAK, UPPER);
+    }
+    else
+    {
+      if(expr.op0().is_constant()) // ! c <= something
+        bound(to_constant_expr(expr.op0()), op[1], STRICT, UPPER);
+      else if(expr.op1().is_constant()) // ! something <= c
+        bound(to_constant_expr(expr.op1()), op[0], STRICT, LOWER);
+    }
+  }
+  else if(expr.id()==ID_lt)
+  {
+    assert(op.size()==2);
+
+    if(value)
+    {
+      if(expr.op0().is_constant()) // c < something
+        bound(to_constant_expr(expr.op0()), op[1], STRICT, LOWER);
+      else if(expr.op1().is_constant()) // something < c
+        bound(to_constant_expr(expr.op1()), op[0], STRICT, UPPER);
+    }
+    else
+    {
+      if(expr.op0().is_constant()) // ! c < something
+        bound(to_constant_expr(expr.op0()), op[1], WEAK, UPPER);
+      else if(expr.op1().is_constant()) // ! something < c
+        bound(to_constant_expr(expr.op1()), op[0], WEAK, LOWER);
+    }
+  }
+  else if(expr.id()==ID_ge)
+  {
+    assert(op.size()==2);
+
+    if(value)
+    {
+      if(expr.op0().is_constant()) // c >= something
+        bound(to_constant_expr(expr.op0()), op[1], WEAK, UPPER);
+      else if(expr.op1().is_constant()) // something >= c
+        bound(to_constant_expr(expr.op1()), op[0], WEAK, LOWER);
+    }
+    else
+    {
+      if(expr.op0().is_constant()) // ! c >= something
+        bound(to_constant_expr(expr.op0()), op[1], STRICT, LOWER);
+      else if(expr.op1().is_constant()) // ! something >= c
+        bound(to_constant_expr(expr.op1()), op[0], STRICT, UPPER);
+    }
+  }
+  else if(expr.id()==ID_gt)
+  {
+    assert(op.size()==2);
+
+    if(value)
+    {
+      if(expr.op0().is_constant()) // c > something
+        bound(to_constant_expr(expr.op0()), op[1], STRICT, UPPER);
+      else if(expr.op1().is_constant()) // something > c
+        bound(to_constant_expr(expr.op1()), op[0], STRICT, LOWER);
+    }
+    else
+    {
+      if(expr.op0().is_constant()) // ! c > something
+        bound(to_constant_expr(expr.op0()), op[1], WEAK, LOWER);
+      else if(expr.op1().is_constant()) // ! something > c
+        bound(to_constant_expr(expr.op1()), op[0], WEAK, UPPER);
+    }
+  }
+}
+
+/*******************************************************************\
+
+Function: solvert::process_uf
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: look for a congruent application of the same function
+
+\*******************************************************************/
+
+void solvert::process_uf(unsigned nr)
+{
+  const solver_exprt &se=expr_map[nr];
+
+  signaturet signature;
+  signature.head=se.head;
+  signature.op.resize(se.op.size());
+
+  for(unsigned i=0; i<se.op.size(); i++)
+    signature.op[i]=equalities.find(se.op[i]);
+
+  std::pair<signature_tablet::iterator, bool> result=
+    signature_table.insert(
+      std::pair<signaturet, unsigned>(signature, nr));
+
+  if(result.second)
+  {
+    if(recording())
+    {
+      trail.push_back(trail_entryt(trail_entryt::SIGNATURE, nr));
+      signature_trail.push_back(signature);
+    }
+  }
+  else
+  {
+    // there is another application with the same signature
+    unsigned e_nr=result.first->second;
+
+    #ifdef DEBUG
+    std::cout << "UF check: "
+              << nr << " = " << e_nr << "\n";
+    #endif
+
+    set_equal(nr, e_nr);
+  }
+}
+
+/*******************************************************************\
+
+Function: integer_type_range
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: the values of an integer type; false if it isn't one
+
+\*******************************************************************/
+
+static bool integer_type_range(
+  const typet &type,
+  mp_integer &min,
+  mp_integer &max)
+{
+  if(type.id()==ID_signedbv)
+  {
+    unsigned width=to_signedbv_type(type).get_width();
+    min=-power(2, width-1);
+    max=power(2, width-1)-1;
+    return true;
+  }
+  else if(type.id()==ID_unsignedbv)
+  {
+    unsigned width=to_unsignedbv_type(type).get_width();
+    min=0;
+    max=power(2, width)-1;
+    return true;
+  }
+  else
+    return false;
+}
+
+/*******************************************************************\
+
+Function: solvert::integer_range
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool solvert::integer_range(
+  unsigned nr,
+  mp_integer &lower,
+  mp_integer &upper)
+{
+  if(!integer_type_range(expr_numbering[nr].type(), lower, upper))
+    return false;
+    
+  const integer_intervalt &interval=
+    integer_intervals[equalities.find(nr)];
+
+  if(interval.lower_set && interval.lower>lower)
+    lower=interval.lower;
+
+  if(interval.upper_set && interval.upper<upper)
+    upper=interval.upper;
+    
+  return true;
+}
+
+/*******************************************************************\
+
+Function: solvert::meet_integer_range
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+bool solvert::meet_integer_range(
+  unsigned nr,
+  const mp_integer &lower,
+  const mp_integer &upper)
+{
+  mp_integer min, max;
+  if(!integer_type_range(expr_numbering[nr].type(), min, max))
+    return false;
+
+  integer_intervalt interval;
+  if(lower>min) interval.set_lower(lower);
+  if(upper<max) interval.set_upper(upper);
+  
+  return meet_integer_interval(equalities.find(nr), interval);
+}
+
+/*******************************************************************\
+
+Function: solvert::process_if_interval
 
   Inputs:
 
  Outputs:
 
- Purpose:
+ Purpose: c ? x : y is within the hull of x and y
 
 \*******************************************************************/
 
-bool solvert::is_equal(const exprt &a, const exprt &b) const
+void solvert::process_if_interval(unsigned nr)
 {
-  exprt tmp_a=a, tmp_b=b;
-  
-  simplify(tmp_a, ns);
-  simplify(tmp_b, ns);
+  const solver_exprt &se=expr_map[nr];
   
-  numbering<exprt>::number_type a_nr, b_nr;
-  if(expr_numbering.get_number(tmp_a, a_nr)) return false;
-  if(expr_numbering.get_number(tmp_b, b_nr)) return false;
-  return is_equal(a_nr, b_nr);
+  mp_integer lower1, upper1, lower2, upper2;
+
+  if(!integer_range(se.op[1], lower1, upper1) ||
+     !integer_range(se.op[2], lower2, upper2))
+    return;
+
+  meet_integer_range(
+    nr, std::min(lower1, lower2), std::max(upper1, upper2));
 }
 
 /*******************************************************************\
 
-Function: solvert::add_operands
+Function: solvert::process_arithmetic_interval
 
   Inputs:
 
  Outputs:
 
- Purpose:
+ Purpose: x+c, c+x and x-c with a constant c move the interval of x
 
 \*******************************************************************/
 
-void solvert::add_operands(unsigned nr)
+void solvert::process_arithmetic_interval(unsigned nr)
 {
-  // expr_numbering is a vector, and thus not stable.
-  // We will call add recursively below.
-  const exprt expr=expr_numbering[nr];
+  const exprt &expr=expr_numbering[nr];
+  const solver_exprt &se=expr_map[nr];
 
-  const exprt::operandst &expr_op=expr.operands();
-  std::vector<unsigned> dest;
+  if(se.op.size()!=2 || arithmetic_budget==0)
+    return;
 
-  dest.resize(expr_op.size());
+  mp_integer c;
+  unsigned x;
 
-  for(unsigned i=0; i<dest.size(); i++)
-    dest[i]=add_rec(expr_op[i]);
+  if(!to_integer(expr.op1(), c))
+    x=se.op[0];
+  else if(expr.id()==ID_plus && !to_integer(expr.op0(), c))
+    x=se.op[1];
+  else
+    return;
 
-  // store    
-  expr_map[nr].op=dest;
+  if(expr.id()==ID_minus)
+    c=-c;
+  
+  // pointer arithmetic has operands of different types
+  if(expr_numbering[x].type()!=expr.type())
+    return;
 
-  // Remember that the operands are contained in the expresion.
-  for(unsigned i=0; i<dest.size(); i++)
-    expr_map[dest[i]].operand_of.push_back(nr);
+  mp_integer min, max, lower, upper;
+
+  if(!integer_type_range(expr.type(), min, max) ||
+     !integer_range(x, lower, upper))
+    return;
+    
+  // nothing is known if it may wrap around
+  if(lower+c<min || upper+c>max)
+    return;
+
+  if(meet_integer_range(nr, lower+c, upper+c))
+    arithmetic_budget--;
 }
 
 /*******************************************************************\
 
-Function: solvert::new_expression
+Function: solvert::process
 
   Inputs:
 
  Outputs:
 
- Purpose:
+ Purpose: apply the rules for the given expression
 
 \*******************************************************************/
 
-void solvert::new_expression(unsigned nr)
+void solvert::process(unsigned nr)
 {
-  // expr_numbering is a vector, and thus not stable.
-  const exprt expr=expr_numbering[nr];
-      
-  if(expr.id()==ID_if)
-  {
-    add_operands(nr);
-    if_list.push_back(nr);
-    
-    // we also add if-s as UFs (uff!)
-    uf_map[ID_if].push_back(nr);
-  }
-  else if(expr.id()==ID_or)
+  if(!expr_map[nr].predicate_processed)
   {
-    add_operands(nr);
-    or_list.push_back(nr);
+    if(is_true(nr))
+      process_predicate(nr, true);
+    else if(is_false(nr))
+      process_predicate(nr, false);
   }
-  else if(expr.id()==ID_and)
+
+  const irep_idt id=expr_numbering[nr].id();
+  const solver_exprt &se=expr_map[nr];
+
+  if(id==ID_if)
   {
-    add_operands(nr);
-    and_list.push_back(nr);
+    if(is_false(se.op[0])) // false ? x : y == y
+    {
+      set_equal(se.op[2], nr);
+    }
+    else if(is_true(se.op[0])) // true ? x : y == x
+    {
+      set_equal(se.op[1], nr);
+    }
+
+    if(is_equal(se.op[2], se.op[1])) // c ? x : x == x
+    {
+      set_equal(se.op[2], nr);
+    }
+
+    process_if_interval(nr);
+
+    // we also do if-s as UFs
+    process_uf(nr);
   }
-  else if(expr.id()==ID_not)
+  else if(id==ID_or)
   {
-    add_operands(nr);
-    not_list.push_back(nr);
+    bool some_true=false;
+    unsigned not_false=0, last=0;
+
+    for(unsigned i=0; i<se.op.size(); i++)
+      if(is_true(se.op[i]))
+        some_true=true;
+      else if(!is_false(se.op[i]))
+      {
+        not_false++;
+        last=se.op[i];
+      }
+
+    if(some_true) // x || true == true
+      set_equal(true_nr, nr);
+    else if(not_false==0) // false || false == false
+      set_equal(false_nr, nr);
+    else if(not_false==1) // x || false == x
+      set_equal(last, nr);
+
+    if(is_false(nr)) // !(x || y) ===> !x, !y
+    {
+      for(unsigned i=0; i<se.op.size(); i++)
+        set_equal(se.op[i], false_nr);
+    }
   }
-  else if(expr.id()==ID_notequal)
+  else if(id==ID_and)
   {
-    // we record x!=y <=> !x==y
-    set_equal(not_exprt(equal_exprt(expr.op0(), expr.op1())),
-              expr);
+    bool some_false=false;
+    unsigned not_true=0, last=0;
+
+    for(unsigned i=0; i<se.op.size(); i++)
+      if(is_false(se.op[i]))
+        some_false=true;
+      else if(!is_true(se.op[i]))
+      {
+        not_true++;
+        last=se.op[i];
+      }
+
+    if(some_false) // x && false == false
+      set_equal(false_nr, nr);
+    else if(not_true==0) // true && true == true
+      set_equal(true_nr, nr);
+    else if(not_true==1) // x && true == x
+      set_equal(last, nr);
+
+    if(is_true(nr)) // a && b == true -> a==true && b==true
+    {
+      for(unsigned i=0; i<se.op.size(); i++)
+        set_equal(se.op[i], true_nr);
+    }
   }
-  else if(expr.id()==ID_equal)
+  else if(id==ID_not)
   {
-    add_operands(nr);
-    equal_list.push_back(nr);
+    if(is_true(se.op[0])) // !true == false
+    {
+      set_equal(false_nr, nr);
+    }
+    else if(is_false(se.op[0])) // !false == true
+    {
+      set_equal(true_nr, nr);
+    }
+
+    if(is_true(nr)) // !true == false
+    {
+      set_equal(false_nr, se.op[0]);
+    }
+    else if(is_false(nr)) // !false == true
+    {
+      set_equal(true_nr, se.op[0]);
+    }
   }
-  else if(expr.id()==ID_address_of)
+  else if(id==ID_equal)
   {
-    // NOT an uninterpreted function, but rather a constant.
+    if(is_equal(se.op[0], se.op[1]))
+      set_equal(true_nr, nr);
+    else if(is_disequal(se.op[0], se.op[1]))
+      set_equal(false_nr, nr);
   }
-  else
+  else if(id==ID_plus || id==ID_minus)
   {
-    if(expr.has_operands()) // make it uninterpreted
-    {
-      add_operands(nr);
-      uf_map[expr.id()].push_back(nr);
-      
-      #ifdef DEBUG
-      std::cout << "UF " << nr << " added: " << expr.id();
-      forall_operands(it, expr) std::cout << " " << add(*it);
-      std::cout << "\n";
-      #endif
-    }
+    process_arithmetic_interval(nr);
+    process_uf(nr);
   }
+  else if(!se.op.empty())
+    process_uf(nr);
 }
 
 /*******************************************************************\
@@ -249,375 +1097,167 @@ Function: solvert::dec_solve
 
 decision_proceduret::resultt solvert::dec_solve()
 {
-  bool progress;
-  
-  do
-  {  
-    progress=false;
-    
-    // rummage through things that are equal to 'true'
-    // and that we haven't processed yet
+  propagate();
+  return conflict?D_UNSATISFIABLE:D_SATISFIABLE;
+}
 
-    for(unsigned i=0; i<equalities.size(); i++)
-    {
-      if(!is_true(i)) continue;
-      if(expr_map[i].predicate_processed) continue;
+/*******************************************************************\
 
-      // remember we have done it
-      expr_map[i].predicate_processed=true;
-      
-      const exprt &expr=expr_numbering[i];
-      
-      #ifdef DEBUG
-      std::cout << "RUMMAGE true: " << from_expr(ns, "", expr) << std::endl;
-      #endif
-      
-      if(expr.id()==ID_equal)
-      {
-        const equal_exprt &equal_expr=to_equal_expr(expr);
-        const exprt &lhs=equal_expr.lhs();
-        const exprt &rhs=equal_expr.rhs();
-      
-        implies_equal(add(lhs), add(rhs), progress);
-      }
-      else if(expr.id()==ID_le)
-      {
-        assert(expr.operands().size()==2);
-        
-        if(expr.op0().is_constant()) // c <= something
-          bound(to_constant_expr(expr.op0()), expr.op1(), WEAK, LOWER, progress);
-        else if(expr.op1().is_constant()) // something <= c
-          bound(to_constant_expr(expr.op1()), expr.op0(), WEAK, UPPER, progress);
-      }
-      else if(expr.id()==ID_lt)
-      {
-        if(expr.op0().is_constant()) // c < something
-          bound(to_constant_expr(expr.op0()), expr.op1(), STRICT, LOWER, progress);
-        else if(expr.op1().is_constant()) // something < c
-          bound(to_constant_expr(expr.op1()), expr.op0(), STRICT, UPPER, progress);
-      }
-    }
+Function: solvert::propagate
 
-    // rummage through things that are equal to 'false'
-    // and that we haven't processed yet
+  Inputs:
 
-    for(unsigned i=0; i<equalities.size(); i++)
-    {
-      if(!is_false(i)) continue;
-      if(expr_map[i].predicate_processed) continue;
+ Outputs:
 
-      // remember we have done it
-      expr_map[i].predicate_processed=true;
-      
-      const exprt &expr=expr_numbering[i];
-      
-      #ifdef DEBUG
-      std::cout << "RUMMAGE false: " << from_expr(ns, "", expr) << std::endl;
-      #endif
-      
-      if(expr.id()==ID_equal)
-      {
-        const equal_exprt &equal_expr=to_equal_expr(expr);
-        const exprt &lhs=equal_expr.lhs();
-        const exprt &rhs=equal_expr.rhs();
-      
-        implies_disequal(add(lhs), add(rhs), progress);
-      }
-      else if(expr.id()==ID_le)
-      {
-        assert(expr.operands().size()==2);
-        
-        if(expr.op0().is_constant()) // ! c <= something
-          bound(to_constant_expr(expr.op0()), expr.op1(), STRICT, UPPER, progress);
-        else if(expr.op1().is_constant()) // ! something <= c
-          bound(to_constant_expr(expr.op1()), expr.op0(), STRICT, LOWER, progress);
-      }
-      else if(expr.id()==ID_lt)
-      {
-        if(expr.op0().is_constant()) // ! c < something
-          bound(to_constant_expr(expr.op0()), expr.op1(), WEAK, UPPER, progress);
-        else if(expr.op1().is_constant()) // ! something < c
-          bound(to_constant_expr(expr.op1()), expr.op0(), WEAK, LOWER, progress);
-      }
-    }
+ Purpose:
 
-    // Add bounds around constants.
-    for(unsigned i=0; i<expr_numbering.size(); i++)
-    {
-      const exprt &e=expr_numbering[i];
-      if(e.is_constant())
-      {
-        bound(to_constant_expr(e), e, WEAK, LOWER, progress);
-        bound(to_constant_expr(e), e, WEAK, UPPER, progress);
-      }
-    }
+\*******************************************************************/
 
-    // Rummage through things that are equal,
-    // and make the bounds meet. Should really use triggers for this.
+void solvert::propagate()
+{
+  // We only look at the expressions that have been triggered
+  // by a change in their class or the classes of their operands.
 
-    // References below aren't stable, thus enlarge now!
-    integer_intervals[expr_numbering.size()-1];
-    ieee_float_intervals[expr_numbering.size()-1];
+  // Contradictions are flagged as soon as they show up,
+  // and we stop there.
 
-    for(unsigned i=0; i<expr_numbering.size(); i++)
-    {
-      unsigned root=equalities.find(i);
-      if(root==i) continue;
-      if(integer_intervals[root].meet(integer_intervals[i])) progress=true;
-      if(integer_intervals[i].meet(integer_intervals[root])) progress=true;
-      if(ieee_float_intervals[root].meet(ieee_float_intervals[i])) progress=true;
-      if(ieee_float_intervals[i].meet(ieee_float_intervals[root])) progress=true;
-    }
+  arithmetic_budget=2*expr_numbering.size();
 
-    for(solver_expr_listt::const_iterator
-        if_it=if_list.begin();
-        if_it!=if_list.end();
-        if_it++)
-    {
-      unsigned e_nr=*if_it;
-      const solver_exprt &se=expr_map[e_nr];
+  while(!worklist.empty() && !conflict)
+  {
+    unsigned nr=worklist.back();
+    worklist.pop_back();
+    expr_map[nr].queued=false;
+    process(nr);
+  }
+}
 
-      if(is_false(se.op[0])) // false ? x : y == y
-      {
-        implies_equal(se.op[2], e_nr, progress);
-      }
-      else if(is_true(se.op[0])) // true ? x : y == x
-      {
-        implies_equal(se.op[1], e_nr, progress);
-      }
+/*******************************************************************\
 
-      if(is_equal(se.op[2], se.op[1])) // c ? x : x == x
-      {
-        implies_equal(se.op[2], e_nr, progress);
-      }
-    }
-    
-    for(solver_expr_listt::const_iterator
-        or_it=or_list.begin();
-        or_it!=or_list.end();
-        or_it++)
-    {
-      unsigned e_nr=*or_it;
-      const solver_exprt &se=expr_map[e_nr];
+Function: solvert::push
 
-      if(is_false(se.op[1])) // x || false == x
-      {
-        implies_equal(se.op[0], e_nr, progress);
-      }
+  Inputs:
 
-      if(is_false(se.op[0])) // false || x == x
-      {
-        implies_equal(se.op[1], e_nr, progress);
-      }
+ Outputs:
 
-      if(is_true(se.op[1])) // x || true == true
-      {
-        implies_equal(true_nr, e_nr, progress);
-      }
+ Purpose: save the current state; we branch from the
+          saturated state
 
-      if(is_true(se.op[0])) // true || x == true
-      {
-        implies_equal(true_nr, e_nr, progress);
-      }
+\*******************************************************************/
 
-      if(is_false(e_nr)) // !(x || y) ===> !x, !y
-      {
-        for(unsigned i=0; i<se.op.size(); i++)
-          implies_equal(se.op[i], false_nr, progress);
-      }
-    }
+void solvert::push()
+{
+  propagate();
 
-    for(solver_expr_listt::const_iterator
-        and_it=and_list.begin();
-        and_it!=and_list.end();
-        and_it++)
-    {
-      unsigned e_nr=*and_it;
-      const solver_exprt &se=expr_map[e_nr];
+  scopes.push_back(scopet());
+  scopet &scope=scopes.back();
 
-      if(is_true(se.op[1])) // x && true == x
-      {
-        implies_equal(se.op[0], e_nr, progress);
-      }
-      
-      if(is_true(se.op[0])) // true && x == x
-      {
-        implies_equal(se.op[1], e_nr, progress);
-      }
+  scope.trail_size=trail.size();
+  scope.expr_count=expr_numbering.size();
 
-      if(is_false(se.op[1])) // x && false == false
-      {
-        implies_equal(false_nr, e_nr, progress);
-      }
-      
-      if(is_false(se.op[0])) // false && x == false
-      {
-        implies_equal(false_nr, e_nr, progress);
-      }
+  // this is empty unless we have a conflict
+  scope.worklist=worklist;
+}
 
-      if(is_true(e_nr)) // a && b == true -> a==true && b==true
-      {
-        for(std::vector<unsigned>::const_iterator
-            o_it=se.op.begin(); o_it!=se.op.end(); o_it++)
-          implies_equal(*o_it, true_nr, progress);
-      }
-    }
+/*******************************************************************\
 
-    for(solver_expr_listt::const_iterator
-        not_it=not_list.begin();
-        not_it!=not_list.end();
-        not_it++)
-    {
-      unsigned e_nr=*not_it;
-      const solver_exprt &se=expr_map[e_nr];
+Function: solvert::pop
 
-      if(is_true(se.op[0])) // !true == false
-      {
-        implies_equal(false_nr, e_nr, progress);
-      }
-      else if(is_false(se.op[0])) // !false == true
-      {
-        implies_equal(true_nr, e_nr, progress);
-      }
+  Inputs:
 
-      if(is_true(e_nr)) // !true == false
-      {
-        implies_equal(false_nr, se.op[0], progress);
-      }
-      else if(is_false(e_nr)) // !false == true
-      {
-        implies_equal(true_nr, se.op[0], progress);
-      }
-    }
+ Outputs:
 
-    for(solver_expr_listt::const_iterator
-        equal_it=equal_list.begin();
-        equal_it!=equal_list.end();
-        equal_it++)
-    {
-      unsigned e_nr=*equal_it;
-      const solver_exprt &se=expr_map[e_nr];
-      
-      unsigned op0=equalities.find(se.op[0]);
-      unsigned op1=equalities.find(se.op[1]);
+ Purpose: go back to the state saved by the matching push()
 
-      // Is it equal?
-      if(is_equal(op0, op1))
-        implies_equal(true_nr, e_nr, progress);
-      
-      // Is there a disequality for this equality?
-      for(disequalitiest::const_iterator
-          d_it=disequalities.begin();
-          d_it!=disequalities.end();
-          d_it++)
-      {
-        const std::set<unsigned> &diseq_set=d_it->second;
-      
-        for(std::set<unsigned>::const_iterator
-            diseq_it=diseq_set.begin(); diseq_it!=diseq_set.end(); diseq_it++)
-        {
-          if(is_equal(d_it->first, op0) &&
-             is_equal(*diseq_it, op1))
-          {
-            implies_equal(false_nr, e_nr, progress);
-          }
-          else if(is_equal(d_it->first, op1) &&
-                  is_equal(*diseq_it, op0))
-          {
-            implies_equal(false_nr, e_nr, progress);
-          }
-        }
-      }
-    }
+\*******************************************************************/
 
-    for(uf_mapt::const_iterator
-        uf_map_it=uf_map.begin();
-        uf_map_it!=uf_map.end();
-        uf_map_it++)
-    {
-      const solver_expr_listt &uf_list=uf_map_it->second;
-    
-      // boo, quadratic!
-      for(solver_expr_listt::const_iterator
-          uf_it1=uf_list.begin();
-          uf_it1!=uf_list.end();
-          uf_it1++)
-      {
-        solver_expr_listt::const_iterator next=uf_it1;
-        next++;
-      
-        for(solver_expr_listt::const_iterator
-            uf_it2=next;
-            uf_it2!=uf_list.end();
-            uf_it2++)
-        {
-          unsigned e_nr1=*uf_it1, e_nr2=*uf_it2;
-          const solver_exprt &se1=expr_map[e_nr1], 
-                             &se2=expr_map[e_nr2];
-
-          // same number of arguments?        
-          if(se1.op.size()!=se2.op.size()) continue;
-          
-          // already equal?
-          if(is_equal(e_nr1, e_nr2)) continue;
-          
-          bool all_equal=true;
-          
-          for(unsigned i=0; i<se1.op.size(); i++)
-          {
-            if(!is_equal(se1.op[i], se2.op[i]))
-            {
-              #ifdef DEBUG
-              std::cout << "UF check " 
-                        << e_nr1 << " vs " << e_nr2
-                        << ": op " << i << " not equal\n";
-              #endif
-              all_equal=false;
-              break;
-            }
-          }
-          
-          if(all_equal)
-          {
-            #ifdef DEBUG
-            std::cout << "UF check: " 
-                      << e_nr1 << " = " << e_nr2 << "\n";
-            #endif
-            implies_equal(e_nr1, e_nr2, progress);
-          }
-        }
-      }
-    }
+void solvert::pop()
+{
+  assert(!scopes.empty());
+  scopet &scope=scopes.back();
+  unsigned expr_count=scope.expr_count;
+
+  // undo in reverse order
+  while(trail.size()>scope.trail_size)
+  {
+    undo(trail.back());
+    trail.pop_back();
   }
-  while(progress);
-  
-  // check if we are consistent
-  
-  if(is_equal(true_nr, false_nr))
-    return D_UNSATISFIABLE;
 
-  for(disequalitiest::const_iterator
-      d_it=disequalities.begin();
-      d_it!=disequalities.end();
-      d_it++)
+  for(unsigned i=0; i<worklist.size(); i++)
+    expr_map[worklist[i]].queued=false;
+
+  worklist.swap(scope.worklist);
+
+  for(unsigned i=0; i<worklist.size(); i++)
+    expr_map[worklist[i]].queued=true;
+
+  scopes.pop_back();
+
+  // We keep the expressions added since the push(), and
+  // their classes have been undone. Their own facts need
+  // to be established again.
+  for(unsigned i=expr_count; i<expr_numbering.size(); i++)
+    expression_facts(i);
+}
+
+/*******************************************************************\
+
+Function: solvert::undo
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void solvert::undo(const trail_entryt &entry)
+{
+  switch(entry.kind)
   {
-    const std::set<unsigned> &diseq_set=d_it->second;
-  
-    for(std::set<unsigned>::const_iterator
-        diseq_it=diseq_set.begin(); diseq_it!=diseq_set.end(); diseq_it++)
+  case trail_entryt::UNION:
     {
-      if(is_equal(d_it->first, *diseq_it))
-        return D_UNSATISFIABLE;
+      unsigned other=entry.a;
+      unsigned root=equalities.find(other);
+      std::vector<unsigned> &root_members=expr_map[root].members;
+      root_members.resize(
+        root_members.size()-expr_map[other].members.size());
+      equalities.undo_union(other);
     }
+    break;
+
+  case trail_entryt::DISEQUALITY:
+    disequalities.erase(root_pairt(
+      std::min(entry.a, entry.b), std::max(entry.a, entry.b)));
+    expr_map[entry.a].disequal_to.pop_back();
+    expr_map[entry.b].disequal_to.pop_back();
+    break;
+
+  case trail_entryt::INTEGER_INTERVAL:
+    integer_intervals[entry.a]=integer_interval_trail.back();
+    integer_interval_trail.pop_back();
+    break;
+
+  case trail_entryt::IEEE_FLOAT_INTERVAL:
+    ieee_float_intervals[entry.a]=ieee_float_interval_trail.back();
+    ieee_float_interval_trail.pop_back();
+    break;
+
+  case trail_entryt::SIGNATURE:
+    signature_table.erase(signature_trail.back());
+    signature_trail.pop_back();
+    break;
+
+  case trail_entryt::PREDICATE_PROCESSED:
+    expr_map[entry.a].predicate_processed=false;
+    break;
+
+  case trail_entryt::CONFLICT:
+    conflict=false;
+    break;
   }
-  
-  for(unsigned i=0; i<expr_numbering.size(); i++)
-  {
-    if(integer_intervals[i].is_bottom()) return D_UNSATISFIABLE;
-    if(ieee_float_intervals[i].is_bottom()) return D_UNSATISFIABLE;
-  }
-
-  return D_SATISFIABLE;
 }
 
 /*******************************************************************\
@@ -712,11 +1352,13 @@ Function: solvert::bound
 
 void solvert::bound(
   const constant_exprt &bound,
-  const exprt &what,
+  unsigned what,
   weak_strictt weak_strict,
-  lower_uppert lower_upper,
-  bool &progress)
+  lower_uppert lower_upper)
 {
+  // the bounds are kept for the root
+  unsigned root=equalities.find(what);
+
   const typet &type=bound.type();
   
   if(type.id()==ID_signedbv || type.id()==ID_unsignedbv)
@@ -739,10 +1381,7 @@ void solvert::bound(
     else
       new_interval.set_upper(int_val);
 
-    integer_intervalt &interval=integer_intervals[add(what)];
-    
-    if(interval.meet(new_interval))
-      progress=true;
+    meet_integer_interval(root, new_interval);
   }
   else if(type.id()==ID_floatbv)
   {
@@ -756,10 +1395,7 @@ void solvert::bound(
     else
       new_interval.set_upper(float_val);
 
-    ieee_float_intervalt &interval=ieee_float_intervals[add(what)];
-
-    if(interval.meet(new_interval))
-      progress=true;
+    meet_ieee_float_interval(root, new_interval);
   }
 }
 
@@ -882,20 +1518,27 @@ void solvert::print_assignment(std::ostream &out) const
     }
   }
   
-  // disequalities
+  // disequalities, between the roots
   
-  for(disequalitiest::const_iterator
-      d_it=disequalities.begin();
-      d_it!=disequalities.end();
-      d_it++)
+  for(unsigned i=0; i<expr_numbering.size(); i++)
   {
-    const std::set<unsigned> &diseq_set=d_it->second;
+    if(equalities.find(i)!=i) continue;
+    
+    const std::vector<unsigned> &disequal_to=expr_map[i].disequal_to;
+    std::set<unsigned> diseq_set;
+    
+    for(std::vector<unsigned>::const_iterator
+        d_it=disequal_to.begin(); d_it!=disequal_to.end(); d_it++)
+    {
+      unsigned d_root=equalities.find(*d_it);
+      if(d_root>i) diseq_set.insert(d_root);
+    }
   
     for(std::set<unsigned>::const_iterator
         diseq_it=diseq_set.begin(); diseq_it!=diseq_set.end(); diseq_it++)
     {
       out << "Disequal: "
-          << from_expr(ns, "", expr_numbering[d_it->first])
+          << from_expr(ns, "", expr_numbering[i])
           << " != "
           << from_expr(ns, "", expr_numbering[*diseq_it])
           << "\n";
@@ -909,15 +1552,17 @@ void solvert::print_assignment(std::ostream &out) const
       i_it!=integer_intervals.end(); i_it++)
   {
     const integer_intervalt &interval=*i_it;
+    unsigned nr=i_it-integer_intervals.begin();
     
     if(interval.is_top()) continue;
+    if(equalities.find(nr)!=nr) continue;
     
     out << "Integer interval: ";
 
     if(interval.lower_set)
       out << interval.lower << " <= ";
 
-    out << from_expr(ns, "", expr_numbering[i_it-integer_intervals.begin()]);
+    out << from_expr(ns, "", expr_numbering[nr]);
     
     if(interval.upper_set)
       out << " <= " << interval.upper;
@@ -932,15 +1577,17 @@ void solvert::print_assignment(std::ostream &out) const
       i_it!=ieee_float_intervals.end(); i_it++)
   {
     const ieee_float_intervalt &interval=*i_it;
+    unsigned nr=i_it-ieee_float_intervals.begin();
     
     if(interval.is_top()) continue;
+    if(equalities.find(nr)!=nr) continue;
     
     out << "Floating-point interval: ";
 
     if(interval.lower_set)
       out << interval.lower << " <= ";
 
-    out << from_expr(ns, "", expr_numbering[i_it-ieee_float_intervals.begin()]);
+    out << from_expr(ns, "", expr_numbering[nr]);
     
     if(interval.upper_set)
       out << " <= " << interval.upper;
@@ -11,12 +11,15 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <set>
 
+#include <util/hash_cont.h>
 #include <util/decision_procedure.h>
 #include <util/union_find.h>
 #include <util/expanding_vector.h>
 
 #include <analyses/intervals.h>
 
+#include "backtracking_union_find.h"
+
 class solvert:public decision_proceduret
 {
 public:
@@ -42,10 +45,26 @@ public:
 
   bool is_equal(const exprt &a, const exprt &b) const;
   
+  // the bounds derived for an integer expression,
+  // top if there are none
+  integer_intervalt get_integer_interval(const exprt &expr) const;
+
   inline void add_expression(const exprt &expr)
   {
     add(expr);
   }
+  
+  // false iff the expression has a comparison or a constant
+  // of floating-point type, where the bounds we take from it
+  // ignore NaN; anything we have no rule for is an uninterpreted
+  // function, and congruence is sound for it
+  static bool trusts(const exprt &expr);
+
+  // Scopes: pop() retracts everything that has been added
+  // or derived since the matching push(). The expressions
+  // themselves are kept.
+  void push();
+  void pop();
 
 protected:
   // Used to determine whether an expression is suitable
@@ -60,67 +79,68 @@ protected:
   // recursively add a simplified expression, returns its handle
   unsigned add_rec(const exprt &expr);
 
-  // make 'a' and 'b' equal
-  inline void set_equal(unsigned a, unsigned b)
-  {
-    equalities.make_union(a, b);
-  }
+  // make 'a' and 'b' equal, and trigger the
+  // expressions that may be affected
+  void set_equal(unsigned a, unsigned b);
 
-  // make 'a' and 'b' equal, and track if
-  // this wasn't the case before
-  inline void implies_equal(unsigned a, unsigned b, bool &progress)
-  {
-    if(is_equal(a, b)) return; // no progres
-    equalities.make_union(a, b);
-    progress=true; // progress!
-  }
-  
-  // add a bound, and track if this is a new bound
+  // add a bound to the class of 'what'
   enum weak_strictt { WEAK, STRICT };
   enum lower_uppert { LOWER, UPPER };
   
   void bound(const constant_exprt &bound,
-             const exprt &what,
+             unsigned what,
              weak_strictt weak_strict,
-             lower_uppert lower_upper,
-             bool &progress);
+             lower_uppert lower_upper);
   
   // a numbering for expressions
   numbering<exprt> expr_numbering;
 
+  // a numbering for the heads of expressions, see solver_exprt
+  numbering<exprt> head_numbering;
+
   // equality logic
-  unsigned_union_find equalities;
+  backtracking_union_findt equalities;
   
   inline bool is_equal(unsigned a, unsigned b) const
   {
     return equalities.find(a)==equalities.find(b);
   }
   
-  // Disequalities; the smaller index is the key.
-  // This should really use roots from the equalities.
-  typedef std::map<unsigned, std::set<unsigned> > disequalitiest;
+  // Disequalities between classes, as pairs of roots,
+  // the smaller one first. Pairs with a root that has been
+  // merged into another class become stale.
+  typedef std::pair<unsigned, unsigned> root_pairt;
+  
+  struct root_pair_hasht
+  {
+    std::size_t operator()(const root_pairt &pair) const
+    {
+      return (std::size_t(pair.first)<<16)^pair.second;
+    }
+  };
+  
+  typedef hash_set_cont<root_pairt, root_pair_hasht> disequalitiest;
   disequalitiest disequalities;
   
   inline bool is_disequal(unsigned a, unsigned b) const
   {
+    a=equalities.find(a);
+    b=equalities.find(b);
     if(a>b) std::swap(a, b);
-    disequalitiest::const_iterator it=disequalities.find(a);
-    if(it==disequalities.end()) return false;
-    return it->second.find(b)!=it->second.end();
+    return disequalities.find(root_pairt(a, b))!=disequalities.end();
   }
 
-  void implies_disequal(unsigned a, unsigned b, bool &progress)
-  {
-    if(a>b) std::swap(a, b);
-    if((disequalities[a].insert(b)).second)
-      progress=true;
-  }
-
-  void set_disequal(unsigned a, unsigned b)
-  {
-    if(a>b) std::swap(a, b);
-    disequalities[a].insert(b);
-  }
+  // make 'a' and 'b' disequal, and trigger the
+  // equalities that may be affected
+  void set_disequal(unsigned a, unsigned b);
+  
+  // record a disequality between two roots,
+  // returns true if it is new
+  bool add_disequality(unsigned root_a, unsigned root_b);
+  
+  // set once we have found a contradiction
+  bool conflict;
+  void set_conflict();
 
   // further data per expression
   struct solver_exprt
@@ -128,12 +148,25 @@ protected:
     // the numbers of the operands
     std::vector<unsigned> op;
     
+    // the number of the expression without its operands,
+    // i.e., id, type and the named subs, such as the
+    // component name of a member expression
+    unsigned head;
+    
     // the numbers of the expressions that contain this one
     std::vector<unsigned> operand_of;
     
-    bool predicate_processed;
+    // the members of the equivalence class,
+    // only maintained for the root
+    std::vector<unsigned> members;
+    
+    // the classes this one is disequal to, only maintained
+    // for the root; these may be stale, use 'find'
+    std::vector<unsigned> disequal_to;
     
-    solver_exprt():predicate_processed(false)
+    bool predicate_processed, queued;
+    
+    solver_exprt():head(0), predicate_processed(false), queued(false)
     {
     }
   };
@@ -141,14 +174,63 @@ protected:
   typedef expanding_vector<solver_exprt> expr_mapt;
   expr_mapt expr_map;
 
-  // lists of expressions with particular IDs  
   typedef std::vector<unsigned> solver_expr_listt;
-  solver_expr_listt if_list, or_list, and_list, not_list, equal_list;
+  
+  // The expressions whose rules need to be looked at again,
+  // as something has changed about them or their operands.
+  solver_expr_listt worklist;
+  
+  inline void enqueue(unsigned nr)
+  {
+    solver_exprt &se=expr_map[nr];
+    if(se.queued) return;
+    se.queued=true;
+    worklist.push_back(nr);
+  }
+  
+  // enqueue the members of a class, and the expressions
+  // that have them as operands
+  void enqueue_class(unsigned root, bool members);
+  
+  // apply the rules for the given expression
+  void process(unsigned nr);
+  void process_predicate(unsigned nr, bool value);
+  void process_uf(unsigned nr);
+  void process_if_interval(unsigned nr);
+  void process_arithmetic_interval(unsigned nr);
 
-  // uninterpreted functions (and predicates), mapping
-  // expression id -> to the list of expressions of this kind  
-  typedef std::map<irep_idt, solver_expr_listt> uf_mapt;
-  uf_mapt uf_map;
+  // Congruence closure for uninterpreted functions (and
+  // predicates): we map the head of the expression and the roots
+  // of the classes of the operands to an application with these.
+  // The id alone isn't enough: (char)x and (int)x have the same
+  // id and operand, and so have s.a and s.b.
+  struct signaturet
+  {
+    unsigned head;
+    std::vector<unsigned> op;
+    
+    inline bool operator==(const signaturet &other) const
+    {
+      return head==other.head && op==other.op;
+    }
+  };
+  
+  struct signature_hasht
+  {
+    std::size_t operator()(const signaturet &signature) const
+    {
+      std::size_t result=signature.head;
+      for(unsigned i=0; i<signature.op.size(); i++)
+        result=(result<<5)^(result>>27)^signature.op[i];
+      return result;
+    }
+  };
+  
+  // Entries for roots that have been merged into another
+  // class become stale; they are never looked up again.
+  typedef hash_map_cont<signaturet, unsigned, signature_hasht>
+    signature_tablet;
+  signature_tablet signature_table;
 
   // builds above solver_exprt for given expression  
   solver_exprt build_solver_expr(unsigned nr);
@@ -158,6 +240,12 @@ protected:
 
   // called after new expresion with given number has been added
   void new_expression(unsigned nr);
+  
+  // the facts that hold for an expression by itself
+  void expression_facts(unsigned nr);
+  
+  // process the worklist
+  void propagate();
 
   // handy numbers of well-known constants
   unsigned false_nr, true_nr;
@@ -172,11 +260,72 @@ protected:
     return is_equal(a, false_nr);
   }
 
-  // interval domain
+  // interval domain, kept for the roots of the equalities
   typedef expanding_vector<integer_intervalt> integer_intervalst;
   typedef expanding_vector<ieee_float_intervalt> ieee_float_intervalst;
   ieee_float_intervalst ieee_float_intervals;
   integer_intervalst integer_intervals;
+  
+  // the values of the class of 'nr', with the bounds of
+  // its type where there are none; false if not an integer
+  bool integer_range(unsigned nr, mp_integer &lower, mp_integer &upper);
+  
+  // meet the class of 'nr' with the given values, leaving
+  // out the bounds its type gives anyway
+  bool meet_integer_range(
+    unsigned nr, const mp_integer &lower, const mp_integer &upper);
+  
+  // Arithmetic over a cycle of equalities, say x==x+1,
+  // narrows an interval by one in each round; we stop
+  // deriving intervals from arithmetic after this many
+  // changes in one propagation.
+  unsigned arithmetic_budget;
+
+  // The changes to the state are logged on a trail,
+  // to be undone by pop(). Nothing is logged outside
+  // of a scope, as there is nothing to go back to.
+  struct trail_entryt
+  {
+    enum kindt
+    {
+      UNION, DISEQUALITY, INTEGER_INTERVAL, IEEE_FLOAT_INTERVAL,
+      SIGNATURE, PREDICATE_PROCESSED, CONFLICT
+    } kind;
+    
+    unsigned a, b;
+    
+    trail_entryt(kindt _kind, unsigned _a, unsigned _b=0):
+      kind(_kind), a(_a), b(_b)
+    {
+    }
+  };
+  
+  typedef std::vector<trail_entryt> trailt;
+  trailt trail;
+
+  // the old values for the interval and signature entries
+  std::vector<integer_intervalt> integer_interval_trail;
+  std::vector<ieee_float_intervalt> ieee_float_interval_trail;
+  std::vector<signaturet> signature_trail;
+  
+  inline bool recording() const
+  {
+    return !scopes.empty();
+  }
+  
+  // returns true if the interval has changed
+  bool meet_integer_interval(unsigned root, const integer_intervalt &);
+  void meet_ieee_float_interval(unsigned root, const ieee_float_intervalt &);
+  
+  void undo(const trail_entryt &);
+  
+  struct scopet
+  {
+    unsigned trail_size, expr_count;
+    solver_expr_listt worklist;
+  };
+  
+  std::vector<scopet> scopes;
 };
 
 #endif
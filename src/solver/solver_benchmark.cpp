@@ -0,0 +1,104 @@
+/*******************************************************************\
+
+Module: Benchmark for the Congruence Closure of the Solver
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#include <util/i2string.h>
+#include <util/std_types.h>
+#include <util/std_expr.h>
+#include <util/symbol_table.h>
+#include <util/namespace.h>
+
+#include "solver.h"
+
+/*******************************************************************\
+
+Function: benchmark
+
+  Inputs: number of applications
+
+ Outputs:
+
+ Purpose: Adds n applications f(x_i), the definitions y_i=f(x_i)
+          and the chain x_i=x_(i+1), and solves once. All the
+          applications end up in one class.
+
+\*******************************************************************/
+
+void benchmark(unsigned n)
+{
+  if(n==0) return;
+
+  symbol_tablet symbol_table;
+  namespacet ns(symbol_table);
+  solvert solver(ns);
+
+  const signedbv_typet int_type(32);
+
+  std::vector<symbol_exprt> x, y;
+
+  for(unsigned i=0; i<=n; i++)
+  {
+    x.push_back(symbol_exprt("x"+i2string(i), int_type));
+    y.push_back(symbol_exprt("y"+i2string(i), int_type));
+  }
+
+  std::vector<exprt> f;
+
+  for(unsigned i=0; i<=n; i++)
+  {
+    exprt application("f", int_type);
+    application.copy_to_operands(x[i]);
+    f.push_back(application);
+  }
+
+  for(unsigned i=0; i<n; i++)
+  {
+    solver.add_expression(f[i]);
+    solver.set_to_true(equal_exprt(y[i], f[i]));
+    solver.set_to_true(equal_exprt(x[i], x[i+1]));
+  }
+
+  clock_t start=clock();
+  decision_proceduret::resultt result=solver.dec_solve();
+  clock_t stop=clock();
+
+  std::cout << n << " "
+            << (result==decision_proceduret::D_SATISFIABLE?"SAT":"UNSAT")
+            << " " << double(stop-start)/CLOCKS_PER_SEC << "s"
+            << " " << (solver.is_equal(f[0], f[n-1])?"congruent":"not congruent")
+            << "\n";
+}
+
+/*******************************************************************\
+
+Function: main
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: solver_benchmark n1 n2 ...
+
+\*******************************************************************/
+
+int main(int argc, const char **argv)
+{
+  if(argc<2)
+  {
+    std::cerr << "usage: solver_benchmark n1 n2 ...\n";
+    return 1;
+  }
+
+  for(int i=1; i<argc; i++)
+    benchmark(atoi(argv[i]));
+
+  return 0;
+}
@@ -36,7 +36,8 @@ void assignmentst::build_assignment_map(
     if(it->is_assign())
     {
       const code_assignt &code_assign=to_code_assign(it->code);
-      exprt lhs_deref=dereference(code_assign.lhs(), ssa_value_ai[it], "", ns);
+      exprt lhs_deref=dereference(
+        code_assign.lhs(), ssa_value_ai[it], "", ns, ssa_value_ai.alias_oracle);
       assign(lhs_deref, it, ns);
     }
     else if(it->is_decl())
@@ -65,7 +66,9 @@ void assignmentst::build_assignment_map(
       // the call might come with an assignment
       if(code_function_call.lhs().is_not_nil())
       {
-        exprt lhs_deref=dereference(code_function_call.lhs(), ssa_value_ai[it], "", ns);
+        exprt lhs_deref=dereference(
+          code_function_call.lhs(), ssa_value_ai[it], "", ns,
+          ssa_value_ai.alias_oracle);
         assign(lhs_deref, it, ns);
       }
     }
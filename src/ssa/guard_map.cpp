@@ -57,6 +57,8 @@ Function: guard_mapt::build
 
 void guard_mapt::build(const goto_programt &src)
 {
+  map.reserve(src);
+
   // first get all branch targets
 
   forall_goto_program_instructions(it, src)
@@ -65,9 +67,15 @@ void guard_mapt::build(const goto_programt &src)
     next++;
   
     if(it->is_goto())
-    {
       map[it->get_target()].add_in(it, TAKEN);
-      
+
+    // There is no location past the end, and thus,
+    // nothing to guard there.
+    if(next==src.instructions.end())
+      continue;
+  
+    if(it->is_goto())
+    {
       if(!it->guard.is_true())
         map[next].add_in(it, NOT_TAKEN);
       else
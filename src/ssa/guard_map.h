@@ -13,6 +13,8 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <cassert>
 #include <map>
 
+#include "location_map.h"
+
 #include <goto-programs/goto_program.h>
 
 class guard_mapt
@@ -111,7 +113,7 @@ public:
 protected:
   void build(const goto_programt &src);
   
-  typedef std::map<locationt, entryt> mapt;
+  typedef location_mapt<entryt> mapt;
   mapt map;
 };
 
@@ -44,6 +44,8 @@ void local_SSAt::build_SSA()
   // perform SSA data-flow analysis
   ssa_analysis(goto_function, ns);
   
+  nodes.reserve(goto_function.body);
+
   // now build phi-nodes
   forall_goto_program_instructions(i_it, goto_function.body)
     build_phi_nodes(i_it);
@@ -110,19 +112,23 @@ Function: local_SSAt::build_phi_nodes
 void local_SSAt::build_phi_nodes(locationt loc)
 {
   const ssa_domaint::phi_nodest &phi_nodes=ssa_analysis[loc].phi_nodes;
+  
+  // Most locations don't have any phi-nodes.
+  if(phi_nodes.empty()) return;
+
   nodet &node=nodes[loc];
 
-  for(objectst::const_iterator
-      o_it=ssa_objects.objects.begin();
-      o_it!=ssa_objects.objects.end(); o_it++)
+  // The phi-nodes are ordered by identifier, like the objects,
+  // and thus, we get the equalities in the same order as when
+  // going through all the objects.
+  for(ssa_domaint::phi_nodest::const_iterator
+      p_it=phi_nodes.begin();
+      p_it!=phi_nodes.end(); p_it++)
   {
-    // phi-node for this object here?
-    ssa_domaint::phi_nodest::const_iterator p_it=
-      phi_nodes.find(o_it->get_identifier());
-          
-    if(p_it==phi_nodes.end()) continue; // none
+    const ssa_objectt *object=ssa_objects.find(p_it->first);
+    if(object==NULL) continue; // not an object we track
     
-    // Yes. Get the source -> def map.
+    // Get the source -> def map.
     const std::map<locationt, ssa_domaint::deft> &incoming=p_it->second;
 
     exprt rhs=nil_exprt();
@@ -140,7 +146,7 @@ void local_SSAt::build_phi_nodes(locationt loc)
          incoming_it->first->location_number < loc->location_number)
       {
         // it's a forward edge
-        exprt incoming_value=name(*o_it, incoming_it->second);
+        exprt incoming_value=name(*object, incoming_it->second);
         exprt incoming_guard=edge_guard(incoming_it->first, loc);
 
         if(rhs.is_nil()) // first
@@ -159,7 +165,7 @@ void local_SSAt::build_phi_nodes(locationt loc)
          incoming_it->first->location_number >= loc->location_number)
       {
         // it's a backwards edge
-        exprt incoming_value=name(*o_it, LOOP_BACK, incoming_it->first);
+        exprt incoming_value=name(*object, LOOP_BACK, incoming_it->first);
         exprt incoming_select=name(guard_symbol(), LOOP_SELECT, incoming_it->first);
 
         if(rhs.is_nil()) // first
@@ -168,7 +174,7 @@ void local_SSAt::build_phi_nodes(locationt loc)
           rhs=if_exprt(incoming_select, incoming_value, rhs);
       }
 
-    symbol_exprt lhs=name(*o_it, PHI, loc);
+    symbol_exprt lhs=name(*object, PHI, loc);
     
     equal_exprt equality(lhs, rhs);
     node.equalities.push_back(equality);
@@ -191,7 +197,7 @@ exprt local_SSAt::dereference(const exprt &src, locationt loc) const
 {
   const ssa_value_domaint &ssa_value_domain=ssa_value_ai[loc];
   const std::string nondet_prefix="deref#"+i2string(loc->location_number);
-  return ::dereference(src, ssa_value_domain, nondet_prefix, ns);
+  return ::dereference(src, ssa_value_domain, nondet_prefix, ns, &alias_oracle);
 }
 
 /*******************************************************************\
@@ -471,7 +477,7 @@ symbol_exprt local_SSAt::read_rhs(
     return name_input(object);
   }
   else
-    return name(object, d_it->second.def);
+    return name(object, d_it->second);
 }
 
 /*******************************************************************\
@@ -555,7 +561,10 @@ exprt local_SSAt::read_node_in(
         incoming_it++)
     {
       if(incoming_it->first->location_number > loc->location_number)
+      {
         has_phi=true;
+        break;
+      }
     }
   }
   
@@ -809,15 +818,27 @@ symbol_exprt local_SSAt::name(
   const irep_idt &id=object.get_identifier();
   unsigned cnt=loc->location_number;
   
-  irep_idt new_id=id2string(id)+"#"+
-                  (kind==PHI?"phi":
-                   kind==LOOP_BACK?"lb":
-                   kind==LOOP_SELECT?"ls":
-                   "")+
-                  i2string(cnt)+
-                  (kind==LOOP_SELECT?std::string(""):suffix);
-
-  new_symbol_expr.set_identifier(new_id);
+  name_keyt key(id, kind, cnt);
+  name_cachet::const_iterator c_it=name_cache.find(key);
+  
+  if(c_it!=name_cache.end())
+  {
+    new_symbol_expr.set_identifier(c_it->second);
+    name_cache_hits++;
+  }
+  else
+  {
+    irep_idt new_id=id2string(id)+"#"+
+                    (kind==PHI?"phi":
+                     kind==LOOP_BACK?"lb":
+                     kind==LOOP_SELECT?"ls":
+                     "")+
+                    i2string(cnt)+suffix;
+
+    name_cache[key]=new_id;
+    names_built++;
+    new_symbol_expr.set_identifier(new_id);
+  }
   
   if(object.get_expr().source_location().is_not_nil())
     new_symbol_expr.add_source_location()=object.get_expr().source_location();
@@ -865,8 +886,21 @@ symbol_exprt local_SSAt::name_input(const ssa_objectt &object) const
 {
   symbol_exprt new_symbol_expr(object.get_expr().type()); // copy
   const irep_idt old_id=object.get_identifier();
-  irep_idt new_id=id2string(old_id)+"#in"+suffix;
-  new_symbol_expr.set_identifier(new_id);
+
+  input_name_cachet::const_iterator c_it=input_name_cache.find(old_id);
+
+  if(c_it!=input_name_cache.end())
+  {
+    new_symbol_expr.set_identifier(c_it->second);
+    name_cache_hits++;
+  }
+  else
+  {
+    irep_idt new_id=id2string(old_id)+"#in"+suffix;
+    input_name_cache[old_id]=new_id;
+    names_built++;
+    new_symbol_expr.set_identifier(new_id);
+  }
 
   if(object.get_expr().source_location().is_not_nil())
     new_symbol_expr.add_source_location()=object.get_expr().source_location();
@@ -1130,6 +1164,60 @@ bool local_SSAt::has_static_lifetime(const exprt &src) const
 
 /*******************************************************************\
 
+Function: local_SSAt::loop_objects
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void local_SSAt::loop_objects(
+  locationt backwards_goto,
+  ssa_objectst::objectst &dest) const
+{
+  assert(backwards_goto->is_backwards_goto());
+
+  locationt loop_head=backwards_goto->get_target();
+
+  // whatever we track and is assigned in the body,
+  // including inner loops
+  for(locationt it=loop_head; ; it++)
+  {
+    const assignmentst::objectst &assigned=assignments.get(it);
+
+    for(assignmentst::objectst::const_iterator
+        a_it=assigned.begin();
+        a_it!=assigned.end();
+        a_it++)
+      if(ssa_objects.objects.find(*a_it)!=ssa_objects.objects.end())
+        dest.insert(*a_it);
+
+    if(it==backwards_goto) break;
+  }
+
+  // The back edge may bring a definition from outside of the
+  // body, if the loop is entered or left by a goto. The phi
+  // nodes at the loop head know.
+  const ssa_domaint::phi_nodest &phi_nodes=ssa_analysis[loop_head].phi_nodes;
+
+  for(ssa_domaint::phi_nodest::const_iterator
+      p_it=phi_nodes.begin();
+      p_it!=phi_nodes.end();
+      p_it++)
+  {
+    if(p_it->second.find(backwards_goto)==p_it->second.end())
+      continue;
+
+    const ssa_objectt *object=ssa_objects.find(p_it->first);
+    if(object!=NULL) dest.insert(*object);
+  }
+}
+
+/*******************************************************************\
+
 Function: local_SSAt::operator <<
 
   Inputs:
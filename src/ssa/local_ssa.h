@@ -10,12 +10,15 @@ Author: Daniel Kroening, kroening@kroening.com
 #define CPROVER_LOCAL_SSA_H
 
 #include <util/std_expr.h>
+#include <util/hash_cont.h>
 
 #include <goto-programs/goto_functions.h>
 
 #include "ssa_domain.h"
 #include "guard_map.h"
+#include "location_map.h"
 #include "ssa_object.h"
+#include "ssa_dereference.h"
 
 class local_SSAt
 {
@@ -26,14 +29,18 @@ public:
   inline local_SSAt(
     const goto_functiont &_goto_function,
     const namespacet &_ns,
-    const std::string &_suffix=""):
+    const std::string &_suffix="",
+    const module_value_sett *_module_value_set=NULL):
     ns(_ns), goto_function(_goto_function), 
+    alias_oracle(_ns),
     ssa_objects(_goto_function, ns),
-    ssa_value_ai(_goto_function, ns),
+    ssa_value_ai(_goto_function, ns, _module_value_set, &alias_oracle),
     assignments(_goto_function.body, ns, ssa_objects, ssa_value_ai),
     guard_map(_goto_function.body),
     ssa_analysis(assignments),
-    suffix(_suffix)
+    suffix(_suffix),
+    names_built(0),
+    name_cache_hits(0)
   {
     build_SSA();
   }
@@ -68,7 +75,7 @@ public:
   void assertions_to_constraints();
 
   // all the SSA nodes  
-  typedef std::map<locationt, nodet> nodest;
+  typedef location_mapt<nodet> nodest;
   nodest nodes;
   inline nodet &operator[](locationt l) { return nodes[l]; }
 
@@ -102,9 +109,17 @@ public:
   
   bool has_static_lifetime(const ssa_objectt &) const;
   bool has_static_lifetime(const exprt &) const;
+
+  // the objects that may change in the loop closed by the
+  // given backwards goto; the others pass through unchanged
+  void loop_objects(
+    locationt backwards_goto, ssa_objectst::objectst &dest) const;
   
   exprt dereference(const exprt &expr, locationt loc) const;
 
+  // shared by the value set analysis and the SSA
+  mutable ssa_alias_oraclet alias_oracle;
+
   ssa_objectst ssa_objects;
   typedef ssa_objectst::objectst objectst;
   ssa_value_ait ssa_value_ai;
@@ -114,7 +129,49 @@ public:
   ssa_ait ssa_analysis;
   std::string suffix; // an extra suffix
 
+  // how many names of SSA symbols have been put together,
+  // and how many have been found in the cache instead
+  mutable unsigned names_built, name_cache_hits;
+
 protected:
+  // The names are built from strings, and then hashed into
+  // the string table, which is expensive for large functions.
+  // We remember the names we have built.
+  struct name_keyt
+  {
+    irep_idt identifier;
+    kindt kind;
+    unsigned location_number;
+
+    inline name_keyt(
+      const irep_idt &_identifier, kindt _kind, unsigned _location_number):
+      identifier(_identifier), kind(_kind), location_number(_location_number)
+    {
+    }
+
+    inline bool operator==(const name_keyt &other) const
+    {
+      return identifier==other.identifier &&
+             kind==other.kind &&
+             location_number==other.location_number;
+    }
+  };
+
+  struct name_key_hasht
+  {
+    inline size_t operator()(const name_keyt &key) const
+    {
+      return irep_id_hash()(key.identifier)^
+             (key.location_number<<2)^key.kind;
+    }
+  };
+
+  typedef hash_map_cont<name_keyt, irep_idt, name_key_hasht> name_cachet;
+  mutable name_cachet name_cache;
+
+  typedef hash_map_cont<irep_idt, irep_idt, irep_id_hash> input_name_cachet;
+  mutable input_name_cachet input_name_cache;
+
   // build the SSA formulas
   void build_SSA();
 
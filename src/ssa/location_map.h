@@ -0,0 +1,229 @@
+/*******************************************************************\
+
+Module: Maps from Program Locations, Stored by Location Number
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#ifndef CPROVER_LOCATION_MAP_H
+#define CPROVER_LOCATION_MAP_H
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include <goto-programs/goto_program.h>
+
+// A replacement for std::map<locationt, T> for the locations of
+// one goto program. The entries are kept in a vector indexed by
+// location_number, and thus, lookups don't chase pointers and
+// iteration is in program order. The location numbers need to
+// be distinct, but don't need to start at zero.
+
+template<class T>
+class location_mapt
+{
+public:
+  typedef goto_programt::const_targett locationt;
+  typedef std::pair<locationt, T> value_type;
+
+  inline location_mapt():base(0), count(0)
+  {
+  }
+
+  template<class mapt, class valuet>
+  class iterator_templatet
+  {
+  public:
+    inline iterator_templatet():map(0), index(0)
+    {
+    }
+
+    inline iterator_templatet(mapt *_map, unsigned _index):
+      map(_map), index(_index)
+    {
+      skip();
+    }
+
+    // iterator to const_iterator
+    template<class mapt2, class valuet2>
+    inline iterator_templatet(const iterator_templatet<mapt2, valuet2> &other):
+      map(other.map), index(other.index)
+    {
+    }
+
+    inline valuet &operator*() const
+    {
+      return map->slots[index];
+    }
+
+    inline valuet *operator->() const
+    {
+      return &map->slots[index];
+    }
+
+    inline iterator_templatet &operator++()
+    {
+      index++;
+      skip();
+      return *this;
+    }
+
+    inline iterator_templatet operator++(int)
+    {
+      iterator_templatet tmp=*this;
+      ++*this;
+      return tmp;
+    }
+
+    template<class mapt2, class valuet2>
+    inline bool operator==(const iterator_templatet<mapt2, valuet2> &other) const
+    {
+      return index==other.index;
+    }
+
+    template<class mapt2, class valuet2>
+    inline bool operator!=(const iterator_templatet<mapt2, valuet2> &other) const
+    {
+      return index!=other.index;
+    }
+
+  protected:
+    template<class, class> friend class iterator_templatet;
+
+    mapt *map;
+    unsigned index;
+
+    // move on to the next location that has an entry
+    inline void skip()
+    {
+      while(index<map->used.size() && !map->used[index])
+        index++;
+    }
+  };
+
+  typedef iterator_templatet<location_mapt, value_type> iterator;
+  typedef iterator_templatet<const location_mapt, const value_type>
+    const_iterator;
+
+  inline iterator begin() { return iterator(this, 0); }
+  inline iterator end() { return iterator(this, slots.size()); }
+  inline const_iterator begin() const { return const_iterator(this, 0); }
+  inline const_iterator end() const { return const_iterator(this, slots.size()); }
+
+  // adds an entry if there is none
+  T &operator[](locationt l)
+  {
+    unsigned index=make_index(l);
+
+    if(!used[index])
+    {
+      used[index]=true;
+      slots[index].first=l;
+      count++;
+    }
+    else
+      assert(slots[index].first==l);
+
+    return slots[index].second;
+  }
+
+  iterator find(locationt l)
+  {
+    unsigned index;
+    if(!get_index(l, index)) return end();
+    return iterator(this, index);
+  }
+
+  const_iterator find(locationt l) const
+  {
+    unsigned index;
+    if(!get_index(l, index)) return end();
+    return const_iterator(this, index);
+  }
+
+  // Makes room for all locations of the program up front.
+  // References to entries are then stable, as with std::map.
+  void reserve(const goto_programt &src)
+  {
+    if(src.instructions.empty()) return;
+
+    unsigned min=src.instructions.front().location_number, max=min;
+
+    forall_goto_program_instructions(it, src)
+    {
+      if(it->location_number<min) min=it->location_number;
+      if(it->location_number>max) max=it->location_number;
+    }
+
+    make_index(src.instructions.begin()); // sets base if empty
+
+    if(min<base)
+    {
+      slots.insert(slots.begin(), base-min, value_type());
+      used.insert(used.begin(), base-min, false);
+      base=min;
+    }
+
+    if(max-base>=slots.size())
+    {
+      slots.resize(max-base+1);
+      used.resize(max-base+1, false);
+    }
+  }
+
+  inline unsigned size() const { return count; }
+  inline bool empty() const { return count==0; }
+
+  void clear()
+  {
+    slots.clear();
+    used.clear();
+    base=0;
+    count=0;
+  }
+
+protected:
+  std::vector<value_type> slots;
+  std::vector<bool> used;
+  unsigned base, count;
+
+  // true if there is an entry for l
+  bool get_index(locationt l, unsigned &index) const
+  {
+    unsigned nr=l->location_number;
+    if(nr<base || nr-base>=slots.size()) return false;
+    index=nr-base;
+    if(!used[index]) return false;
+    assert(slots[index].first==l);
+    return true;
+  }
+
+  // makes room for l
+  unsigned make_index(locationt l)
+  {
+    unsigned nr=l->location_number;
+
+    if(slots.empty())
+      base=nr;
+    else if(nr<base)
+    {
+      // rare: the locations usually come in program order
+      unsigned extra=base-nr;
+      slots.insert(slots.begin(), extra, value_type());
+      used.insert(used.begin(), extra, false);
+      base=nr;
+    }
+
+    if(nr-base>=slots.size())
+    {
+      slots.resize(nr-base+1);
+      used.resize(nr-base+1, false);
+    }
+
+    return nr-base;
+  }
+};
+
+#endif
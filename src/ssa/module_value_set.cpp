@@ -0,0 +1,573 @@
+/*******************************************************************\
+
+Module: A flow-insensitive value set analysis for a whole program
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <util/i2string.h>
+#include <util/std_code.h>
+
+#include "module_value_set.h"
+#include "ssa_dereference.h"
+
+// bump when the format of the file changes
+#define MODULE_VALUE_SET_FORMAT "1"
+
+/*******************************************************************\
+
+Function: get_object_path
+
+  Inputs:
+
+ Outputs: true if the object is symbol(.member)*, for a
+          symbol in the symbol table
+
+ Purpose: These are the objects we can write into a file
+          and get back.
+
+\*******************************************************************/
+
+static bool get_object_path(
+  const exprt &src,
+  const namespacet &ns,
+  irep_idt &root,
+  std::vector<irep_idt> &components)
+{
+  if(src.id()==ID_symbol)
+  {
+    if(is_ptr_object(src)) return false;
+    root=to_symbol_expr(src).get_identifier();
+    const symbolt *symbol;
+    return !ns.lookup(root, symbol);
+  }
+  else if(src.id()==ID_member)
+  {
+    const member_exprt &member_expr=to_member_expr(src);
+    if(!get_object_path(member_expr.struct_op(), ns, root, components))
+      return false;
+    components.push_back(member_expr.get_component_name());
+    return true;
+  }
+  else
+    return false;
+}
+
+/*******************************************************************\
+
+Function: build_object
+
+  Inputs:
+
+ Outputs: nil if there is no such object
+
+ Purpose: the inverse of get_object_path
+
+\*******************************************************************/
+
+static exprt build_object(
+  const irep_idt &root,
+  const std::vector<irep_idt> &components,
+  const namespacet &ns)
+{
+  const symbolt *symbol;
+  if(ns.lookup(root, symbol)) return nil_exprt();
+
+  exprt result=symbol->symbol_expr();
+
+  for(std::vector<irep_idt>::const_iterator
+      c_it=components.begin();
+      c_it!=components.end();
+      c_it++)
+  {
+    const typet &type=ns.follow(result.type());
+    if(type.id()!=ID_struct) return nil_exprt();
+
+    const struct_typet &struct_type=to_struct_type(type);
+    if(!struct_type.has_component(*c_it)) return nil_exprt();
+
+    result=member_exprt(
+      result, *c_it, struct_type.get_component(*c_it).type());
+  }
+
+  return result;
+}
+
+/*******************************************************************\
+
+Function: module_value_sett::operator()
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void module_value_sett::operator()(const goto_functionst &goto_functions)
+{
+  domain.value_map.clear();
+
+  // The updates are weak, and thus, we are done
+  // once a pass over all instructions changes nothing.
+  while(true)
+  {
+    ssa_value_domaint::value_mapt old_value_map=domain.value_map;
+
+    forall_goto_functions(f_it, goto_functions)
+      forall_goto_program_instructions(i_it, f_it->second.body)
+        transform(i_it, goto_functions);
+
+    if(domain.value_map==old_value_map) break;
+  }
+
+  restrict_to_seeds();
+}
+
+/*******************************************************************\
+
+Function: module_value_sett::transform
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void module_value_sett::transform(
+  goto_programt::const_targett i_it,
+  const goto_functionst &goto_functions)
+{
+  if(i_it->is_assign())
+  {
+    const code_assignt &assignment=to_code_assign(i_it->code);
+    exprt lhs_deref=dereference(assignment.lhs(), domain, "", ns);
+    exprt rhs_deref=dereference(assignment.rhs(), domain, "", ns);
+    domain.assign_lhs_rec(lhs_deref, rhs_deref, ns, true);
+  }
+  else if(i_it->is_function_call())
+  {
+    const code_function_callt &code_function_call=
+      to_code_function_call(i_it->code);
+
+    // calls via function pointers are left to the functions
+    if(code_function_call.function().id()!=ID_symbol)
+      return;
+
+    const irep_idt &identifier=
+      to_symbol_expr(code_function_call.function()).get_identifier();
+
+    goto_functionst::function_mapt::const_iterator f_it=
+      goto_functions.function_map.find(identifier);
+
+    if(f_it==goto_functions.function_map.end())
+      return;
+
+    const code_typet::parameterst &parameters=
+      f_it->second.type.parameters();
+    const exprt::operandst &arguments=code_function_call.arguments();
+
+    for(unsigned i=0; i<parameters.size() && i<arguments.size(); i++)
+    {
+      const irep_idt &parameter_id=parameters[i].get_identifier();
+      if(parameter_id==irep_idt()) continue;
+
+      symbol_exprt lhs(parameter_id, parameters[i].type());
+      exprt rhs_deref=dereference(arguments[i], domain, "", ns);
+      domain.assign_lhs_rec(lhs, rhs_deref, ns, true);
+    }
+  }
+}
+
+/*******************************************************************\
+
+Function: module_value_sett::is_seed
+
+  Inputs:
+
+ Outputs: true if the function gets the values of the object
+
+ Purpose:
+
+\*******************************************************************/
+
+bool module_value_sett::is_seed(
+  const ssa_objectt &object,
+  const goto_functionst::goto_functiont &goto_function) const
+{
+  irep_idt root;
+  std::vector<irep_idt> components;
+
+  if(!get_object_path(object.get_expr(), ns, root, components))
+    return false;
+
+  const symbolt &symbol=ns.lookup(root);
+
+  if(symbol.is_static_lifetime)
+    return true;
+
+  if(!symbol.is_parameter)
+    return false;
+
+  const code_typet::parameterst &parameters=
+    goto_function.type.parameters();
+
+  for(code_typet::parameterst::const_iterator
+      p_it=parameters.begin();
+      p_it!=parameters.end();
+      p_it++)
+    if(p_it->get_identifier()==root)
+      return true;
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: module_value_sett::restrict_to_seeds
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: The locals only matter while we compute the values,
+          and we drop the objects we couldn't write into a file.
+          That loses precision only: the dereferencing falls
+          back to a nondeterministic value for any object
+          that isn't in the value set.
+
+\*******************************************************************/
+
+void module_value_sett::restrict_to_seeds()
+{
+  ssa_value_domaint::value_mapt new_value_map;
+
+  for(ssa_value_domaint::value_mapt::const_iterator
+      v_it=domain.value_map.begin();
+      v_it!=domain.value_map.end();
+      v_it++)
+  {
+    irep_idt root;
+    std::vector<irep_idt> components;
+
+    if(!get_object_path(v_it->first.get_expr(), ns, root, components))
+      continue;
+
+    const symbolt &symbol=ns.lookup(root);
+    if(!symbol.is_static_lifetime && !symbol.is_parameter)
+      continue;
+
+    ssa_value_domaint::valuest values=v_it->second;
+    values.value_set=ssa_value_domaint::object_sett();
+
+    std::vector<ssa_objectt> objects;
+    domain.get_objects(v_it->second, objects);
+
+    for(std::vector<ssa_objectt>::const_iterator
+        o_it=objects.begin();
+        o_it!=objects.end();
+        o_it++)
+    {
+      irep_idt o_root;
+      std::vector<irep_idt> o_components;
+
+      if(get_object_path(o_it->get_expr(), ns, o_root, o_components))
+        values.value_set.insert(object_numbering.number(*o_it));
+    }
+
+    if(!values.empty())
+      new_value_map[v_it->first]=values;
+  }
+
+  domain.value_map.swap(new_value_map);
+}
+
+/*******************************************************************\
+
+Function: module_value_sett::seed
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void module_value_sett::seed(
+  const goto_functionst::goto_functiont &goto_function,
+  ssa_value_domaint &dest,
+  ssa_object_numberingt &dest_numbering) const
+{
+  for(ssa_value_domaint::value_mapt::const_iterator
+      v_it=domain.value_map.begin();
+      v_it!=domain.value_map.end();
+      v_it++)
+  {
+    if(!is_seed(v_it->first, goto_function)) continue;
+
+    // the numbers of the objects differ
+    ssa_value_domaint::valuest values=v_it->second;
+    values.value_set=ssa_value_domaint::object_sett();
+
+    std::vector<ssa_objectt> objects;
+    domain.get_objects(v_it->second, objects);
+
+    for(std::vector<ssa_objectt>::const_iterator
+        o_it=objects.begin();
+        o_it!=objects.end();
+        o_it++)
+      values.value_set.insert(dest_numbering.number(*o_it));
+
+    dest.value_map[v_it->first]=values;
+  }
+}
+
+/*******************************************************************\
+
+Function: module_value_sett::output_seed
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void module_value_sett::output_seed(
+  const goto_functionst::goto_functiont &goto_function,
+  std::ostream &out) const
+{
+  for(ssa_value_domaint::value_mapt::const_iterator
+      v_it=domain.value_map.begin();
+      v_it!=domain.value_map.end();
+      v_it++)
+  {
+    if(!is_seed(v_it->first, goto_function)) continue;
+
+    out << v_it->first.get_identifier() << ':';
+    v_it->second.output(out, object_numbering, ns);
+    out << '\n';
+  }
+}
+
+/*******************************************************************\
+
+Function: module_value_sett::output
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void module_value_sett::output(std::ostream &out) const
+{
+  for(ssa_value_domaint::value_mapt::const_iterator
+      v_it=domain.value_map.begin();
+      v_it!=domain.value_map.end();
+      v_it++)
+  {
+    out << v_it->first.get_identifier() << ':';
+    v_it->second.output(out, object_numbering, ns);
+    out << '\n';
+  }
+}
+
+/*******************************************************************\
+
+Function: module_value_sett::write
+
+  Inputs:
+
+ Outputs: true on error
+
+ Purpose: Objects are written as the symbol and the members,
+          one line each, and are referred to by number in the
+          lines for the values. We write a temporary file
+          first, and rename it, as another process may be
+          reading the file.
+
+\*******************************************************************/
+
+bool module_value_sett::write(
+  const std::string &file_name,
+  const std::string &key) const
+{
+  std::string tmp_name=file_name+".tmp"+i2string((unsigned long)getpid());
+
+  {
+    std::ofstream out(tmp_name.c_str());
+
+    out << "deltacheck-values " MODULE_VALUE_SET_FORMAT "\n";
+    out << "K " << key << "\n";
+
+    // the objects we have values for may not have a number yet
+    ssa_object_numberingt file_numbering=object_numbering;
+
+    for(ssa_value_domaint::value_mapt::const_iterator
+        v_it=domain.value_map.begin();
+        v_it!=domain.value_map.end();
+        v_it++)
+      file_numbering.number(v_it->first);
+
+    for(unsigned nr=0; nr<file_numbering.size(); nr++)
+    {
+      irep_idt root;
+      std::vector<irep_idt> components;
+
+      if(!get_object_path(
+           file_numbering[nr].get_expr(), ns, root, components))
+        continue;
+
+      out << "O " << nr << ' ' << root;
+
+      for(unsigned i=0; i<components.size(); i++)
+        out << ' ' << components[i];
+
+      out << '\n';
+    }
+
+    for(ssa_value_domaint::value_mapt::const_iterator
+        v_it=domain.value_map.begin();
+        v_it!=domain.value_map.end();
+        v_it++)
+    {
+      const ssa_value_domaint::valuest &values=v_it->second;
+
+      out << "V " << file_numbering.number(v_it->first)
+          << ' ' << values.offset
+          << ' ' << values.null
+          << ' ' << values.unknown
+          << ' ' << values.integer_address
+          << ' ' << values.alignment;
+
+      std::vector<unsigned> numbers;
+      values.value_set.get_numbers(numbers);
+
+      for(unsigned i=0; i<numbers.size(); i++)
+        out << ' ' << numbers[i];
+
+      out << '\n';
+    }
+
+    out.close();
+
+    if(!out)
+    {
+      remove(tmp_name.c_str());
+      return true;
+    }
+  }
+
+  if(rename(tmp_name.c_str(), file_name.c_str())!=0)
+  {
+    remove(tmp_name.c_str());
+    return true;
+  }
+
+  return false;
+}
+
+/*******************************************************************\
+
+Function: module_value_sett::read
+
+  Inputs:
+
+ Outputs: true on error, which includes a key that doesn't match
+
+ Purpose:
+
+\*******************************************************************/
+
+bool module_value_sett::read(
+  const std::string &file_name,
+  const std::string &key)
+{
+  std::ifstream in(file_name.c_str());
+  if(!in) return true;
+
+  std::string line;
+
+  if(!std::getline(in, line) ||
+     line!="deltacheck-values " MODULE_VALUE_SET_FORMAT)
+    return true;
+
+  if(!std::getline(in, line) || line!="K "+key)
+    return true;
+
+  // the numbers in the file to ours
+  std::map<unsigned, unsigned> number_map;
+  ssa_value_domaint::value_mapt new_value_map;
+
+  while(std::getline(in, line))
+  {
+    std::istringstream line_in(line);
+    std::string kind;
+    unsigned nr;
+
+    if(!(line_in >> kind >> nr))
+      return true;
+
+    if(kind=="O")
+    {
+      std::string root, component;
+      std::vector<irep_idt> components;
+
+      if(!(line_in >> root)) return true;
+
+      while(line_in >> component)
+        components.push_back(component);
+
+      exprt expr=build_object(root, components, ns);
+      if(expr.is_nil()) return true; // not the same program
+
+      number_map[nr]=object_numbering.number(ssa_objectt(expr, ns));
+    }
+    else if(kind=="V")
+    {
+      std::map<unsigned, unsigned>::const_iterator n_it=
+        number_map.find(nr);
+      if(n_it==number_map.end()) return true;
+
+      ssa_value_domaint::valuest values;
+
+      if(!(line_in >> values.offset >> values.null >> values.unknown
+                   >> values.integer_address >> values.alignment))
+        return true;
+
+      unsigned target;
+
+      while(line_in >> target)
+      {
+        std::map<unsigned, unsigned>::const_iterator t_it=
+          number_map.find(target);
+        if(t_it==number_map.end()) return true;
+        values.value_set.insert(t_it->second);
+      }
+
+      new_value_map[object_numbering[n_it->second]]=values;
+    }
+    else
+      return true;
+  }
+
+  domain.value_map.swap(new_value_map);
+
+  return false;
+}
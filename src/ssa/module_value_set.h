@@ -0,0 +1,74 @@
+/*******************************************************************\
+
+Module: A flow-insensitive value set analysis for a whole program
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#ifndef CPROVER_MODULE_VALUE_SET_H
+#define CPROVER_MODULE_VALUE_SET_H
+
+#include <iosfwd>
+#include <string>
+
+#include "ssa_value_set.h"
+
+// The values that the global variables and the parameters
+// may have anywhere in the program. Assignments are weak
+// updates, and calls assign the arguments to the parameters.
+// This runs once per goto model, and the value sets of the
+// functions start from it.
+
+class module_value_sett
+{
+public:
+  explicit module_value_sett(const namespacet &_ns):ns(_ns)
+  {
+    domain.object_numbering=&object_numbering;
+  }
+
+  void operator()(const goto_functionst &);
+
+  // puts the values of the globals and the parameters
+  // of the function into the given entry state
+  void seed(
+    const goto_functionst::goto_functiont &,
+    ssa_value_domaint &dest,
+    ssa_object_numberingt &dest_numbering) const;
+
+  // what seed() gives the function, as text
+  void output_seed(
+    const goto_functionst::goto_functiont &,
+    std::ostream &) const;
+
+  void output(std::ostream &) const;
+
+  // The results can be kept in a file, say next to the
+  // goto binary. The key says what they were computed for.
+  // true on error
+  bool read(const std::string &file_name, const std::string &key);
+  bool write(const std::string &file_name, const std::string &key) const;
+
+protected:
+  const namespacet &ns;
+  ssa_object_numberingt object_numbering;
+  ssa_value_domaint domain;
+
+  void transform(
+    goto_programt::const_targett,
+    const goto_functionst &);
+
+  bool is_seed(
+    const ssa_objectt &,
+    const goto_functionst::goto_functiont &) const;
+
+  void restrict_to_seeds();
+
+private:
+  // the domain refers to our object numbering
+  module_value_sett(const module_value_sett &);
+  module_value_sett &operator=(const module_value_sett &);
+};
+
+#endif
@@ -0,0 +1,359 @@
+/*******************************************************************\
+
+Module: Maps from Identifiers that Share Structure on Copy
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#ifndef CPROVER_SHARING_MAP_H
+#define CPROVER_SHARING_MAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <util/irep.h>
+
+// A persistent map from identifiers to values. It's a trie over
+// the number of the identifier in the string table, with 16
+// children per node. Copying a map is constant time, and an
+// update copies the path to the entry only, and thus, maps that
+// are copied and then changed a little share most of their nodes.
+// The numbers are what irep_idt's operator< compares, and thus,
+// iteration is in the same order as for std::map<irep_idt, T>.
+
+template<class T>
+class sharing_mapt
+{
+public:
+  typedef irep_idt key_type;
+  typedef T mapped_type;
+  typedef std::pair<irep_idt, T> value_type;
+
+protected:
+  enum { BITS=4, FANOUT=1<<BITS, LEVELS=32/BITS };
+
+  struct nodet
+  {
+    unsigned ref_count;
+    inline nodet():ref_count(1) { }
+  };
+
+  struct inner_nodet:public nodet
+  {
+    // inner nodes on the last level have leaves as children
+    nodet *children[FANOUT];
+
+    inline inner_nodet()
+    {
+      for(unsigned i=0; i<FANOUT; i++) children[i]=NULL;
+    }
+  };
+
+  struct leaf_nodet:public nodet
+  {
+    value_type value;
+    inline explicit leaf_nodet(const value_type &_value):value(_value) { }
+  };
+
+  static inline unsigned digit(unsigned key, unsigned level)
+  {
+    return (key>>(32-BITS*(level+1)))&(FANOUT-1);
+  }
+
+public:
+  inline sharing_mapt():root(NULL), count(0)
+  {
+  }
+
+  inline sharing_mapt(const sharing_mapt &other):
+    root(other.root), count(other.count)
+  {
+    if(root!=NULL) root->ref_count++;
+  }
+
+  inline sharing_mapt &operator=(const sharing_mapt &other)
+  {
+    if(other.root!=NULL) other.root->ref_count++;
+    release(root, 0);
+    root=other.root;
+    count=other.count;
+    return *this;
+  }
+
+  inline ~sharing_mapt()
+  {
+    release(root, 0);
+  }
+
+  class const_iterator
+  {
+  public:
+    inline const_iterator():leaf(NULL)
+    {
+    }
+
+    inline const value_type &operator*() const
+    {
+      return leaf->value;
+    }
+
+    inline const value_type *operator->() const
+    {
+      return &leaf->value;
+    }
+
+    inline const_iterator &operator++()
+    {
+      index[LEVELS-1]++;
+      seek(LEVELS-1);
+      return *this;
+    }
+
+    inline const_iterator operator++(int)
+    {
+      const_iterator tmp=*this;
+      ++*this;
+      return tmp;
+    }
+
+    inline bool operator==(const const_iterator &other) const
+    {
+      return leaf==other.leaf;
+    }
+
+    inline bool operator!=(const const_iterator &other) const
+    {
+      return leaf!=other.leaf;
+    }
+
+  protected:
+    friend class sharing_mapt;
+
+    const inner_nodet *path[LEVELS];
+    unsigned index[LEVELS];
+    const leaf_nodet *leaf;
+
+    // finds the first leaf at or after the position at 'level'
+    void seek(int level)
+    {
+      while(level>=0)
+      {
+        const inner_nodet *n=path[level];
+        unsigned &i=index[level];
+
+        while(i<FANOUT && n->children[i]==NULL) i++;
+
+        if(i==FANOUT)
+        {
+          // done with this node, go up
+          level--;
+          if(level>=0) index[level]++;
+        }
+        else if(level==LEVELS-1)
+        {
+          leaf=static_cast<const leaf_nodet *>(n->children[i]);
+          return;
+        }
+        else
+        {
+          path[level+1]=static_cast<const inner_nodet *>(n->children[i]);
+          index[level+1]=0;
+          level++;
+        }
+      }
+
+      leaf=NULL;
+    }
+  };
+
+  inline const_iterator begin() const
+  {
+    const_iterator it;
+    if(root==NULL) return it;
+    it.path[0]=static_cast<const inner_nodet *>(root);
+    it.index[0]=0;
+    it.seek(0);
+    return it;
+  }
+
+  inline const_iterator end() const
+  {
+    return const_iterator();
+  }
+
+  const_iterator find(const irep_idt &key) const
+  {
+    unsigned nr=key.get_no();
+    const inner_nodet *n=static_cast<const inner_nodet *>(root);
+    const_iterator it;
+
+    for(unsigned level=0; n!=NULL; level++)
+    {
+      unsigned i=digit(nr, level);
+      it.path[level]=n;
+      it.index[level]=i;
+
+      if(level==LEVELS-1)
+      {
+        it.leaf=static_cast<const leaf_nodet *>(n->children[i]);
+        return it;
+      }
+
+      n=static_cast<const inner_nodet *>(n->children[i]);
+    }
+
+    return end();
+  }
+
+  // adds an entry if there is none, and makes it unshared
+  T &operator[](const irep_idt &key)
+  {
+    unsigned nr=key.get_no();
+    nodet **p=&root;
+
+    for(unsigned level=0; level<LEVELS; level++)
+    {
+      inner_nodet *n=make_unique_inner(*p);
+      *p=n;
+      p=&n->children[digit(nr, level)];
+    }
+
+    leaf_nodet *leaf=static_cast<leaf_nodet *>(*p);
+
+    if(leaf==NULL)
+    {
+      leaf=new leaf_nodet(value_type(key, T()));
+      count++;
+    }
+    else if(leaf->ref_count>1)
+    {
+      leaf->ref_count--;
+      leaf=new leaf_nodet(leaf->value);
+    }
+
+    *p=leaf;
+    return leaf->value.second;
+  }
+
+  void erase(const irep_idt &key)
+  {
+    if(find(key)==end()) return; // don't copy the path for nothing
+
+    unsigned nr=key.get_no();
+    nodet **p=&root;
+
+    for(unsigned level=0; level<LEVELS; level++)
+    {
+      inner_nodet *n=make_unique_inner(*p);
+      *p=n;
+      p=&n->children[digit(nr, level)];
+    }
+
+    // Empty inner nodes stay; they go when the map goes.
+    release(*p, LEVELS);
+    *p=NULL;
+    count--;
+  }
+
+  inline void clear()
+  {
+    release(root, 0);
+    root=NULL;
+    count=0;
+  }
+
+  inline std::size_t size() const { return count; }
+  inline bool empty() const { return count==0; }
+
+  // Appends the entries of 'other' that are not shared with
+  // this map, in the order of iteration. Entries that are
+  // shared are the same in both maps. The pointers are valid
+  // as long as 'other' doesn't change.
+  void get_delta(
+    const sharing_mapt &other,
+    std::vector<const value_type *> &dest) const
+  {
+    get_delta_rec(
+      static_cast<const inner_nodet *>(root),
+      static_cast<const inner_nodet *>(other.root),
+      0, dest);
+  }
+
+protected:
+  nodet *root;
+  std::size_t count;
+
+  static void release(nodet *n, unsigned level)
+  {
+    if(n==NULL) return;
+
+    assert(n->ref_count!=0);
+    if(--n->ref_count!=0) return;
+
+    if(level==LEVELS)
+      delete static_cast<leaf_nodet *>(n);
+    else
+    {
+      inner_nodet *inner=static_cast<inner_nodet *>(n);
+
+      for(unsigned i=0; i<FANOUT; i++)
+        release(inner->children[i], level+1);
+
+      delete inner;
+    }
+  }
+
+  // returns a node that only the caller refers to
+  static inner_nodet *make_unique_inner(nodet *n)
+  {
+    if(n==NULL)
+      return new inner_nodet;
+
+    inner_nodet *inner=static_cast<inner_nodet *>(n);
+
+    if(inner->ref_count==1)
+      return inner;
+
+    inner_nodet *copy=new inner_nodet;
+
+    for(unsigned i=0; i<FANOUT; i++)
+    {
+      copy->children[i]=inner->children[i];
+      if(copy->children[i]!=NULL)
+        copy->children[i]->ref_count++;
+    }
+
+    inner->ref_count--;
+    return copy;
+  }
+
+  static void get_delta_rec(
+    const inner_nodet *a,
+    const inner_nodet *b,
+    unsigned level,
+    std::vector<const value_type *> &dest)
+  {
+    if(b==NULL || a==b) return;
+
+    for(unsigned i=0; i<FANOUT; i++)
+    {
+      const nodet *child_a=a==NULL?NULL:a->children[i];
+      const nodet *child_b=b->children[i];
+
+      if(child_b==NULL || child_a==child_b) continue;
+
+      if(level==LEVELS-1)
+        dest.push_back(&static_cast<const leaf_nodet *>(child_b)->value);
+      else
+        get_delta_rec(
+          static_cast<const inner_nodet *>(child_a),
+          static_cast<const inner_nodet *>(child_b),
+          level+1, dest);
+    }
+  }
+};
+
+#endif
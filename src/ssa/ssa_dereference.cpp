@@ -195,6 +195,28 @@ bool ssa_may_alias(
 
 /*******************************************************************\
 
+Function: get_alias_info
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void get_alias_info(
+  const exprt &src,
+  const namespacet &ns,
+  ssa_alias_infot &dest)
+{
+  dest.address=address_canonizer(address_of_exprt(src), ns);
+  dest.size=pointer_offset_size(src.type(), ns);
+  dest.type=ns.follow(src.type());
+}
+
+/*******************************************************************\
+
 Function: ssa_alias_guard
 
   Inputs:
@@ -206,19 +228,16 @@ Function: ssa_alias_guard
 \*******************************************************************/
 
 exprt ssa_alias_guard(
-  const exprt &e1,
-  const exprt &e2,
+  const ssa_alias_infot &i1,
+  const ssa_alias_infot &i2,
   const namespacet &ns)
 {
-  exprt a1=address_canonizer(address_of_exprt(e1), ns);
-  exprt a2=address_canonizer(address_of_exprt(e2), ns);
+  const exprt &a1=i1.address;
+  const exprt &a2=i2.address;
   
   // in some cases, we can use plain address equality,
   // as we assume well-aligned-ness
-  mp_integer size1=pointer_offset_size(e1.type(), ns);
-  mp_integer size2=pointer_offset_size(e2.type(), ns);
-  
-  if(size1>=size2)
+  if(i1.size>=i2.size)
   {
     exprt lhs=a1;
     exprt rhs=a2;
@@ -245,20 +264,19 @@ Function: ssa_alias_value
 
 exprt ssa_alias_value(
   const exprt &e1,
+  const ssa_alias_infot &i1,
   const exprt &e2,
+  const ssa_alias_infot &i2,
   const namespacet &ns)
 {
-  const typet &e1_type=ns.follow(e1.type());
-  const typet &e2_type=ns.follow(e2.type());
+  const typet &e1_type=i1.type;
+  const typet &e2_type=i2.type;
 
   // type matches?
   if(e1_type==e2_type)
     return e2;
 
-  exprt a1=address_canonizer(address_of_exprt(e1), ns);
-  exprt a2=address_canonizer(address_of_exprt(e2), ns);
-  
-  exprt offset1=pointer_offset(a1);
+  exprt offset1=pointer_offset(i1.address);
 
   // array index possible?
   if(e2_type.id()==ID_array &&
@@ -286,6 +304,66 @@ exprt ssa_alias_value(
 
 /*******************************************************************\
 
+Function: ssa_alias_oraclet::operator()
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_alias_oraclet::operator()(
+  const exprt &src,
+  const ssa_objectt &object,
+  exprt &guard,
+  exprt &value)
+{
+  queries++;
+
+  keyt key(src, object.get_identifier());
+
+  answerst::const_iterator a_it=answers.find(key);
+
+  if(a_it!=answers.end())
+  {
+    hits++;
+    guard=a_it->second.guard;
+    value=a_it->second.value;
+    return;
+  }
+
+  expr_infost::iterator e_it=expr_infos.find(src);
+
+  if(e_it==expr_infos.end())
+  {
+    e_it=expr_infos.insert(
+      std::pair<exprt, ssa_alias_infot>(src, ssa_alias_infot())).first;
+    get_alias_info(src, ns, e_it->second);
+  }
+
+  object_infost::iterator o_it=object_infos.find(object.get_identifier());
+
+  if(o_it==object_infos.end())
+  {
+    o_it=object_infos.insert(
+      std::pair<irep_idt, ssa_alias_infot>(
+        object.get_identifier(), ssa_alias_infot())).first;
+    get_alias_info(object.get_expr(), ns, o_it->second);
+  }
+
+  answert &answer=answers[key];
+  answer.guard=ssa_alias_guard(e_it->second, o_it->second, ns);
+  answer.value=ssa_alias_value(
+    src, e_it->second, object.get_expr(), o_it->second, ns);
+
+  guard=answer.guard;
+  value=answer.value;
+}
+
+/*******************************************************************\
+
 Function: dereference_rec
 
   Inputs:
@@ -300,12 +378,13 @@ exprt dereference_rec(
  const exprt &src,
  const ssa_value_domaint &ssa_value_domain, 
  const std::string &nondet_prefix,
- const namespacet &ns)
+ const namespacet &ns,
+ ssa_alias_oraclet *alias_oracle)
 {
   if(src.id()==ID_dereference)
   {
     const exprt &pointer=to_dereference_expr(src).pointer();
-    exprt pointer_deref=dereference(pointer, ssa_value_domain, nondet_prefix, ns);
+    exprt pointer_deref=dereference(pointer, ssa_value_domain, nondet_prefix, ns, alias_oracle);
 
     // We use the identifier produced by
     // local_SSAt::replace_side_effects_rec
@@ -315,13 +394,27 @@ exprt dereference_rec(
     const ssa_value_domaint::valuest values=
       ssa_value_domain(pointer, ns);
 
-    for(ssa_value_domaint::valuest::value_sett::const_iterator
-        it=values.value_set.begin();
-        it!=values.value_set.end();
+    std::vector<ssa_objectt> objects;
+    ssa_value_domain.get_objects(values, objects);
+
+    for(std::vector<ssa_objectt>::const_iterator
+        it=objects.begin();
+        it!=objects.end();
         it++)
     {
-      exprt guard=ssa_alias_guard(src, it->get_expr(), ns);
-      exprt value=ssa_alias_value(src, it->get_expr(), ns);
+      exprt guard, value;
+
+      if(alias_oracle!=NULL)
+        (*alias_oracle)(src, *it, guard, value);
+      else
+      {
+        ssa_alias_infot i1, i2;
+        get_alias_info(src, ns, i1);
+        get_alias_info(it->get_expr(), ns, i2);
+        guard=ssa_alias_guard(i1, i2, ns);
+        value=ssa_alias_value(src, i1, it->get_expr(), i2, ns);
+      }
+
       result=if_exprt(guard, value, result);
     }
 
@@ -330,7 +423,7 @@ exprt dereference_rec(
   else if(src.id()==ID_member)
   {
     member_exprt tmp=to_member_expr(src);
-    tmp.struct_op()=dereference_rec(tmp.struct_op(), ssa_value_domain, nondet_prefix, ns);
+    tmp.struct_op()=dereference_rec(tmp.struct_op(), ssa_value_domain, nondet_prefix, ns, alias_oracle);
     
     #ifdef DEBUG
     std::cout << "dereference_rec tmp: " << from_expr(ns, "", tmp) << '\n';
@@ -344,7 +437,7 @@ exprt dereference_rec(
   else if(src.id()==ID_address_of)
   {
     address_of_exprt tmp=to_address_of_expr(src);
-    tmp.object()=dereference_rec(tmp.object(), ssa_value_domain, nondet_prefix, ns);
+    tmp.object()=dereference_rec(tmp.object(), ssa_value_domain, nondet_prefix, ns, alias_oracle);
 
     if(tmp.object().is_nil())
       return nil_exprt();
@@ -355,7 +448,7 @@ exprt dereference_rec(
   {
     exprt tmp=src;
     Forall_operands(it, tmp)
-      *it=dereference_rec(*it, ssa_value_domain, nondet_prefix, ns);
+      *it=dereference_rec(*it, ssa_value_domain, nondet_prefix, ns, alias_oracle);
     return tmp;
   }
 }
@@ -376,13 +469,14 @@ exprt dereference(
  const exprt &src,
  const ssa_value_domaint &ssa_value_domain, 
  const std::string &nondet_prefix,
- const namespacet &ns)
+ const namespacet &ns,
+ ssa_alias_oraclet *alias_oracle)
 {
   #ifdef DEBUG
   std::cout << "dereference src: " << from_expr(ns, "", src) << '\n';
   #endif
 
-  exprt tmp1=dereference_rec(src, ssa_value_domain, nondet_prefix, ns);
+  exprt tmp1=dereference_rec(src, ssa_value_domain, nondet_prefix, ns, alias_oracle);
 
   #ifdef DEBUG
   std::cout << "dereference tmp1: " << from_expr(ns, "", tmp1) << '\n';
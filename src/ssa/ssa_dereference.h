@@ -11,6 +11,8 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <util/std_expr.h>
 #include <util/namespace.h>
+#include <util/hash_cont.h>
+#include <util/mp_arith.h>
 
 #include "ssa_value_set.h"
 
@@ -18,10 +20,68 @@ Author: Daniel Kroening, kroening@kroening.com
 //exprt ssa_alias_guard(const exprt &, const exprt &, const namespacet &);
 //exprt ssa_alias_value(const exprt &, const exprt &, const namespacet &);
 
+// what the alias guard and value need to know about
+// either side of a may-alias pair
+struct ssa_alias_infot
+{
+  exprt address; // canonized
+  mp_integer size;
+  typet type; // followed
+};
+
+// Remembers the guard and the value for dereferencing an
+// expression when the pointer points to a given object.
+// These don't depend on the location, and the same pairs
+// come up at many locations of a function.
+class ssa_alias_oraclet
+{
+public:
+  explicit ssa_alias_oraclet(const namespacet &_ns):
+    queries(0), hits(0), ns(_ns)
+  {
+  }
+
+  void operator()(
+    const exprt &src, const ssa_objectt &object,
+    exprt &guard, exprt &value);
+
+  unsigned queries, hits;
+
+protected:
+  const namespacet &ns;
+
+  typedef hash_map_cont<exprt, ssa_alias_infot, irep_hash> expr_infost;
+  expr_infost expr_infos;
+
+  typedef hash_map_cont<irep_idt, ssa_alias_infot, irep_id_hash>
+    object_infost;
+  object_infost object_infos;
+
+  typedef std::pair<exprt, irep_idt> keyt;
+
+  struct key_hasht
+  {
+    inline size_t operator()(const keyt &key) const
+    {
+      return key.first.hash()^irep_id_hash()(key.second);
+    }
+  };
+
+  struct answert
+  {
+    exprt guard, value;
+  };
+
+  typedef hash_map_cont<keyt, answert, key_hasht> answerst;
+  answerst answers;
+};
+
+// The oracle is optional.
 exprt dereference(
   const exprt &,
   const ssa_value_domaint &,
   const std::string &nondet_prefix,
-  const namespacet &);
+  const namespacet &,
+  ssa_alias_oraclet *alias_oracle=NULL);
 
 #endif
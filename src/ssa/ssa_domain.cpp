@@ -38,7 +38,8 @@ void ssa_domaint::output(
       d_it!=def_map.end();
       d_it++)
   {
-    out << "DEF " << d_it->first << ": " << d_it->second << "\n";
+    out << "DEF " << d_it->first << ": " << d_it->second
+        << " from " << get_source(d_it->first)->location_number << "\n";
   }
 
   for(phi_nodest::const_iterator
@@ -62,6 +63,26 @@ void ssa_domaint::output(
 
 /*******************************************************************\
 
+Function: ssa_domaint::set_source
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_domaint::set_source(const irep_idt &id, locationt loc)
+{
+  if(loc==source)
+    source_map.erase(id);
+  else
+    source_map[id]=loc;
+}
+
+/*******************************************************************\
+
 Function: ssa_domaint::transform
 
   Inputs:
@@ -90,10 +111,9 @@ void ssa_domaint::transform(
     {
       irep_idt identifier=o_it->get_identifier();
 
-      def_entryt &def_entry=def_map[identifier];
-      def_entry.def.loc=from;
-      def_entry.def.kind=deft::ASSIGNMENT;
-      def_entry.source=from;
+      deft &def=def_map[identifier];
+      def.loc=from;
+      def.kind=deft::ASSIGNMENT;
     }
   }
   else if(from->is_dead())
@@ -104,9 +124,8 @@ void ssa_domaint::transform(
   }
   
   // update source in all defs
-  for(def_mapt::iterator
-      d_it=def_map.begin(); d_it!=def_map.end(); d_it++)
-    d_it->second.source=from;
+  source=from;
+  source_map.clear();
 }
 
 /*******************************************************************\
@@ -115,9 +134,10 @@ Function: ssa_domaint::merge
 
   Inputs:
 
- Outputs:
+ Outputs: Return true if "this" has changed.
 
- Purpose:
+ Purpose: 'b' has just been transformed by 'from', and thus, all
+          of its definitions come from 'from'.
 
 \*******************************************************************/
 
@@ -126,60 +146,102 @@ bool ssa_domaint::merge(
   locationt from,
   locationt to)
 {
+  // The first time round, we simply take b's definitions.
+  if(def_map.empty() && phi_nodes.empty())
+  {
+    def_map=b.def_map;
+    source=from;
+    source_map.clear();
+    return !def_map.empty();
+  }
+
   bool result=false;
   
-  // should traverse both maps simultaneously
-  for(def_mapt::const_iterator
-      d_it_b=b.def_map.begin();
-      d_it_b!=b.def_map.end();
+  // The existing phi nodes get the edge, even if
+  // the definitions agree.
+  std::vector<irep_idt> phi_updates;
+
+  for(phi_nodest::const_iterator
+      p_it=phi_nodes.begin();
+      p_it!=phi_nodes.end();
+      p_it++)
+  {
+    def_mapt::const_iterator d_it_b=b.def_map.find(p_it->first);
+    if(d_it_b==b.def_map.end()) continue;
+
+    // don't unshare the phi node if it's there already
+    std::map<locationt, deft>::const_iterator e_it=
+      p_it->second.find(from);
+    if(e_it!=p_it->second.end() && e_it->second==d_it_b->second)
+      continue;
+
+    phi_updates.push_back(p_it->first);
+  }
+
+  for(std::vector<irep_idt>::const_iterator
+      u_it=phi_updates.begin();
+      u_it!=phi_updates.end();
+      u_it++)
+  {
+    phi_nodes[*u_it][from]=b.def_map.find(*u_it)->second;
+    // doesn't get propagated, don't set result to 'true'
+  }
+
+  // The definitions we share with b agree;
+  // we only look at the others.
+  std::vector<const def_mapt::value_type *> delta;
+  def_map.get_delta(b.def_map, delta);
+
+  for(std::vector<const def_mapt::value_type *>::const_iterator
+      d_it_b=delta.begin();
+      d_it_b!=delta.end();
       d_it_b++)
   {
-    const irep_idt &id=d_it_b->first;
+    const irep_idt &id=(*d_it_b)->first;
+    const deft &def_b=(*d_it_b)->second;
 
-    // check if we have a phi node for 'id'
-  
-    phi_nodest::iterator p_it=phi_nodes.find(id);
-    if(p_it!=phi_nodes.end())
-    {
-      // yes, simply add to existing phi node
-      std::map<locationt, deft> &phi_node=p_it->second;
-      phi_node[d_it_b->second.source]=d_it_b->second.def;      
-      // doesn't get propagated, don't set result to 'true'
+    // done above if we have a phi node for 'id'
+    if(phi_nodes.find(id)!=phi_nodes.end())
       continue;
-    }
 
     // have we seen this variable yet?
-    def_mapt::iterator d_it_a=def_map.find(id);
+    def_mapt::const_iterator d_it_a=def_map.find(id);
     if(d_it_a==def_map.end())
     {
       // no entry in 'this' yet, simply create a new entry
-      def_map[id]=d_it_b->second;
+      def_map[id]=def_b;
+      set_source(id, from);
       result=true;
 
       #ifdef DEBUG
-      std::cout << "SETTING " << id << ": " << def_map[id] << "\n";
+      std::cout << "SETTING " << id << ": " << def_b << "\n";
       #endif
       continue;
     }
 
-    // we have two entries, compare
-    if(d_it_a->second.def==d_it_b->second.def)
+    // we have two entries, compare; copy, as we are
+    // about to change the map
+    deft def_a=d_it_a->second;
+
+    if(def_a==def_b)
     {
       #ifdef DEBUG
-      std::cout << "AGREE " << id << ": " << d_it_b->second << "\n";
+      std::cout << "AGREE " << id << ": " << def_b << "\n";
       #endif
       continue;
     }
 
     // Different definitions. Are they coming from the same source?
-    if(d_it_a->second.source==d_it_b->second.source)
+    locationt source_a=get_source(id);
+
+    if(source_a==from)
     {
       // Propagate the new definition for same source.
-      d_it_a->second.def=d_it_b->second.def;
+      def_map[id]=def_b;
       result=true;
 
       #ifdef DEBUG
-      std::cout << "OVERWRITING " << id << ": " << def_map[id] << "\n";
+      std::cout << "OVERWRITING " << id << ": " << def_b << "\n";
       #endif
     }
     else
@@ -188,18 +250,19 @@ bool ssa_domaint::merge(
       // We produce a new phi node.
       std::map<locationt, deft> &phi_node=phi_nodes[id];
 
-      phi_node[d_it_a->second.source]=d_it_a->second.def;
-      phi_node[d_it_b->second.source]=d_it_b->second.def;
+      phi_node[source_a]=def_a;
+      phi_node[from]=def_b;
       
       // This phi node is now the new source.
-      d_it_a->second.def.loc=to;
-      d_it_a->second.def.kind=deft::PHI;
-      d_it_a->second.source=to;
+      deft &def=def_map[id];
+      def.loc=to;
+      def.kind=deft::PHI;
+      set_source(id, to);
 
       result=true;
 
       #ifdef DEBUG
-      std::cout << "MERGING " << id << ": " << d_it_b->second << "\n";
+      std::cout << "MERGING " << id << ": " << def_b << "\n";
       #endif
     }
   }
@@ -238,9 +301,8 @@ void ssa_ait::initialize(const goto_functionst::goto_functiont &goto_function)
         p_it++)
     {
       irep_idt id=p_it->get_identifier();
-      entry.def_map[id].source=e;
-      entry.def_map[id].def.loc=e;
-      entry.def_map[id].def.kind=ssa_domaint::deft::INPUT;
+      entry.def_map[id].loc=e;
+      entry.def_map[id].kind=ssa_domaint::deft::INPUT;
     }
     #endif
     
@@ -250,9 +312,12 @@ void ssa_ait::initialize(const goto_functionst::goto_functiont &goto_function)
         o_it++)
     {
       irep_idt id=o_it->get_identifier();
-      entry.def_map[id].source=e;
-      entry.def_map[id].def.loc=e;
-      entry.def_map[id].def.kind=ssa_domaint::deft::INPUT;
+      ssa_domaint::deft &def=entry.def_map[id];
+      def.loc=e;
+      def.kind=ssa_domaint::deft::INPUT;
     }
+
+    entry.source=e;
+    entry.source_map.clear();
   }
 }
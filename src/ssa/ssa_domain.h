@@ -12,6 +12,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <analyses/ai.h>
 
 #include "assignments.h"
+#include "sharing_map.h"
 
 class ssa_domaint:public ai_domain_baset
 {
@@ -46,28 +47,31 @@ public:
     return out;
   }
 
-  // definition and source for an identifier
-  struct def_entryt
-  {
-    def_entryt() { }
-    deft def;
-    locationt source; // information from?
-  };
+  // The definitions for the identifiers. There is one of these
+  // maps per location, and most of them differ little from their
+  // neighbours, and thus, they share their structure.
+  typedef sharing_mapt<deft> def_mapt;
+  def_mapt def_map;
 
-  friend inline std::ostream & operator << (
-    std::ostream &out, const def_entryt &d)
+  // Where the information about an identifier came from:
+  // 'source', unless there is an entry in 'source_map'.
+  locationt source;
+  typedef sharing_mapt<locationt> source_mapt;
+  source_mapt source_map;
+
+  inline locationt get_source(const irep_idt &id) const
   {
-    return out << d.def << " from " << d.source->location_number;
+    source_mapt::const_iterator s_it=source_map.find(id);
+    return s_it==source_map.end()?source:s_it->second;
   }
-  
-  typedef std::map<irep_idt, def_entryt> def_mapt;
-  def_mapt def_map;
+
+  void set_source(const irep_idt &id, locationt);
   
   // The phi nodes map identifiers to incoming branches:
   // map from source to definition.
   // Warning: as this maps locations, which are memory addresses,
   // the ordering in the second map is non-deterministic.
-  typedef std::map<irep_idt, std::map<locationt, deft> > phi_nodest;
+  typedef sharing_mapt<std::map<locationt, deft> > phi_nodest;
   phi_nodest phi_nodes;
 
   virtual void transform(
@@ -0,0 +1,286 @@
+/*******************************************************************\
+
+Module: Induction Variables of the Loops of the SSA
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#include <util/arith_tools.h>
+
+#include "ssa_induction.h"
+
+/*******************************************************************\
+
+Function: ssa_inductiont::ssa_inductiont
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+ssa_inductiont::ssa_inductiont(const local_SSAt &_SSA):SSA(_SSA)
+{
+  for(local_SSAt::nodest::const_iterator
+      n_it=SSA.nodes.begin();
+      n_it!=SSA.nodes.end();
+      n_it++)
+  {
+    const local_SSAt::nodet::equalitiest &equalities=
+      n_it->second.equalities;
+
+    for(local_SSAt::nodet::equalitiest::const_iterator
+        e_it=equalities.begin();
+        e_it!=equalities.end();
+        e_it++)
+      if(e_it->lhs().id()==ID_symbol)
+        definitions[to_symbol_expr(e_it->lhs()).get_identifier()]=
+          e_it->rhs();
+  }
+}
+
+/*******************************************************************\
+
+Function: ssa_inductiont::definition
+
+  Inputs:
+
+ Outputs: the right-hand side of the definition of a symbol,
+          and otherwise the expression itself
+
+ Purpose:
+
+\*******************************************************************/
+
+const exprt &ssa_inductiont::definition(const exprt &src) const
+{
+  if(src.id()!=ID_symbol) return src;
+
+  definitionst::const_iterator d_it=
+    definitions.find(to_symbol_expr(src).get_identifier());
+
+  return d_it==definitions.end()?src:d_it->second;
+}
+
+/*******************************************************************\
+
+Function: ssa_inductiont::get_constant
+
+  Inputs:
+
+ Outputs: true if not a constant
+
+ Purpose:
+
+\*******************************************************************/
+
+bool ssa_inductiont::get_constant(
+  const exprt &src,
+  mp_integer &value) const
+{
+  const exprt *p=&src;
+
+  // the definitions are acyclic, but may be long
+  for(unsigned i=0; i<100 && p->id()==ID_symbol; i++)
+  {
+    const exprt &d=definition(*p);
+    if(&d==p) break;
+    p=&d;
+  }
+
+  if(!p->is_constant()) return true;
+
+  return to_integer(*p, value);
+}
+
+/*******************************************************************\
+
+Function: ssa_inductiont::get_stride
+
+  Inputs:
+
+ Outputs: true if 'update' isn't 'phi' plus a constant
+
+ Purpose:
+
+\*******************************************************************/
+
+bool ssa_inductiont::get_stride(
+  const exprt &update,
+  const symbol_exprt &phi,
+  mp_integer &stride) const
+{
+  const exprt &rhs=definition(update);
+
+  if(rhs.operands().size()!=2) return true;
+
+  if(rhs.id()==ID_plus)
+  {
+    if(rhs.op0()==phi)
+      return get_constant(rhs.op1(), stride);
+    else if(rhs.op1()==phi)
+      return get_constant(rhs.op0(), stride);
+  }
+  else if(rhs.id()==ID_minus)
+  {
+    if(rhs.op0()==phi && !get_constant(rhs.op1(), stride))
+    {
+      stride=-stride;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*******************************************************************\
+
+Function: ssa_inductiont::condition_bounds
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: A comparison of the value at the loop head with a
+          constant, say i<n, bounds the value after the update
+          on the path that stays in the loop.
+
+\*******************************************************************/
+
+void ssa_inductiont::condition_bounds(
+  locationt backwards_goto,
+  const ssa_objectt &object,
+  const symbol_exprt &phi,
+  const mp_integer &stride,
+  boundst &dest) const
+{
+  for(locationt l=backwards_goto->get_target(); ; l++)
+  {
+    if(l->is_goto() || l->is_assume())
+    {
+      const symbol_exprt cond_symbol=SSA.cond_symbol(l);
+      const exprt *cond=&definition(cond_symbol);
+      if(cond->id()==ID_not && cond->operands().size()==1)
+        cond=&cond->op0();
+
+      irep_idt relation=cond->id();
+      mp_integer b;
+
+      if(cond->operands().size()!=2)
+        relation=irep_idt();
+      else if(cond->op0()==phi && !get_constant(cond->op1(), b))
+      {
+        // phi relation b
+      }
+      else if(cond->op1()==phi && !get_constant(cond->op0(), b))
+      {
+        // b relation phi, i.e., phi mirrored b
+        if(relation==ID_lt) relation=ID_gt;
+        else if(relation==ID_gt) relation=ID_lt;
+        else if(relation==ID_le) relation=ID_ge;
+        else if(relation==ID_ge) relation=ID_le;
+      }
+      else
+        relation=irep_idt();
+
+      const typet &type=object.type();
+
+      if(stride>0)
+      {
+        if(relation==ID_lt)
+          dest.push_back(boundt(object, ID_le, from_integer(b-1+stride, type)));
+        else if(relation==ID_le)
+          dest.push_back(boundt(object, ID_le, from_integer(b+stride, type)));
+        else if(relation==ID_notequal && stride==1)
+          dest.push_back(boundt(object, ID_le, from_integer(b, type)));
+      }
+      else
+      {
+        if(relation==ID_gt)
+          dest.push_back(boundt(object, ID_ge, from_integer(b+1+stride, type)));
+        else if(relation==ID_ge)
+          dest.push_back(boundt(object, ID_ge, from_integer(b+stride, type)));
+        else if(relation==ID_notequal && stride==-1)
+          dest.push_back(boundt(object, ID_ge, from_integer(b, type)));
+      }
+    }
+
+    if(l==backwards_goto) break;
+  }
+}
+
+/*******************************************************************\
+
+Function: ssa_inductiont::operator()
+
+  Inputs:
+
+ Outputs: the number of induction variables
+
+ Purpose:
+
+\*******************************************************************/
+
+unsigned ssa_inductiont::operator()(
+  locationt backwards_goto,
+  boundst &dest) const
+{
+  assert(backwards_goto->is_backwards_goto());
+
+  locationt loop_head=backwards_goto->get_target();
+
+  ssa_objectst::objectst objects;
+  SSA.loop_objects(backwards_goto, objects);
+
+  symbol_exprt select=
+    SSA.name(SSA.guard_symbol(), local_SSAt::LOOP_SELECT, backwards_goto);
+
+  unsigned count=0;
+
+  for(ssa_objectst::objectst::const_iterator
+      o_it=objects.begin();
+      o_it!=objects.end();
+      o_it++)
+  {
+    const typet &type=o_it->type();
+
+    if(type.id()!=ID_signedbv && type.id()!=ID_unsignedbv)
+      continue;
+
+    symbol_exprt phi=SSA.name(*o_it, local_SSAt::PHI, loop_head);
+    symbol_exprt back=SSA.name(*o_it, local_SSAt::LOOP_BACK, backwards_goto);
+
+    // The phi node must be 'select?back:entry', i.e., this
+    // is the only backwards goto to the head.
+    const exprt &phi_rhs=definition(phi);
+
+    if(phi_rhs.id()!=ID_if) continue;
+
+    const if_exprt &if_expr=to_if_expr(phi_rhs);
+
+    if(if_expr.cond()!=select || if_expr.true_case()!=back)
+      continue;
+
+    mp_integer initial;
+    if(get_constant(if_expr.false_case(), initial))
+      continue;
+
+    // the update has to be on all paths
+    mp_integer stride;
+    if(get_stride(SSA.read_rhs(*o_it, backwards_goto), phi, stride) ||
+       stride==0)
+      continue;
+
+    count++;
+
+    dest.push_back(boundt(*o_it, stride>0?ID_ge:ID_le,
+                          from_integer(initial, type)));
+
+    condition_bounds(backwards_goto, *o_it, phi, stride, dest);
+  }
+
+  return count;
+}
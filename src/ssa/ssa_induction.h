@@ -0,0 +1,85 @@
+/*******************************************************************\
+
+Module: Induction Variables of the Loops of the SSA
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#ifndef CPROVER_SSA_INDUCTION_H
+#define CPROVER_SSA_INDUCTION_H
+
+#include <list>
+
+#include <util/hash_cont.h>
+
+#include "local_ssa.h"
+
+// An induction variable of a loop is an integer object whose
+// value at the backwards goto is its value at the loop head
+// plus a constant, and whose value on entry to the loop is a
+// constant. Its values then have a closed-form bound on the
+// side of the entry value, and possibly one from a comparison
+// with a constant in the loop. We only propose these bounds,
+// as the values may wrap around; the caller has to check them.
+
+class ssa_inductiont
+{
+public:
+  typedef local_SSAt::locationt locationt;
+
+  explicit ssa_inductiont(const local_SSAt &);
+
+  // the value of 'object' when coming back along the
+  // backwards goto stands in 'relation' (ID_le or ID_ge)
+  // to 'bound'
+  struct boundt
+  {
+    boundt(
+      const ssa_objectt &_object,
+      const irep_idt &_relation,
+      const exprt &_bound):
+      object(_object), relation(_relation), bound(_bound)
+    {
+    }
+
+    ssa_objectt object;
+    irep_idt relation;
+    exprt bound;
+  };
+
+  typedef std::list<boundt> boundst;
+
+  // Adds candidate bounds for the induction variables of
+  // the loop closed by the given backwards goto. Returns
+  // the number of induction variables.
+  unsigned operator()(locationt backwards_goto, boundst &dest) const;
+
+protected:
+  const local_SSAt &SSA;
+
+  // the right-hand side for each SSA symbol
+  typedef hash_map_cont<irep_idt, exprt, irep_id_hash> definitionst;
+  definitionst definitions;
+
+  const exprt &definition(const exprt &) const;
+
+  // follows copies and returns the constant, if any;
+  // true if not a constant
+  bool get_constant(const exprt &, mp_integer &) const;
+
+  // true if 'update' isn't 'phi' plus a constant
+  bool get_stride(
+    const exprt &update,
+    const symbol_exprt &phi,
+    mp_integer &stride) const;
+
+  void condition_bounds(
+    locationt backwards_goto,
+    const ssa_objectt &,
+    const symbol_exprt &phi,
+    const mp_integer &stride,
+    boundst &dest) const;
+};
+
+#endif
@@ -181,6 +181,33 @@ void ssa_objectst::collect_objects(
 
 /*******************************************************************\
 
+Function: ssa_objectst::number_objects
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_objectst::number_objects()
+{
+  object_vector.clear();
+  object_vector.reserve(objects.size());
+  object_numbers.clear();
+
+  for(objectst::const_iterator o_it=objects.begin();
+      o_it!=objects.end();
+      o_it++)
+  {
+    object_numbers[o_it->get_identifier()]=object_vector.size();
+    object_vector.push_back(*o_it);
+  }
+}
+
+/*******************************************************************\
+
 Function: ssa_objectst::add_ptr_objects
 
   Inputs:
@@ -9,6 +9,8 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_SSA_OBJECTS_H
 #define CPROVER_SSA_OBJECTS_H
 
+#include <util/hash_cont.h>
+
 #include <goto-programs/goto_functions.h>
 
 class ssa_objectt
@@ -103,6 +105,22 @@ public:
   typedef std::set<exprt> literalst;
   literalst literals;
 
+  // A dense numbering of 'objects', in the same order,
+  // for finding them by identifier without a search.
+  typedef std::vector<ssa_objectt> object_vectort;
+  object_vectort object_vector;
+
+  typedef hash_map_cont<irep_idt, unsigned, irep_id_hash> object_numberst;
+  object_numberst object_numbers;
+
+  // NULL if there is no such object
+  inline const ssa_objectt *find(const irep_idt &identifier) const
+  {
+    object_numberst::const_iterator it=object_numbers.find(identifier);
+    if(it==object_numbers.end()) return NULL;
+    return &object_vector[it->second];
+  }
+
   ssa_objectst(
     const goto_functionst::goto_functiont &goto_function,
     const namespacet &ns)
@@ -110,6 +128,7 @@ public:
     collect_objects(goto_function, ns);
     add_ptr_objects(ns);
     categorize_objects(goto_function, ns);
+    number_objects();
   }
   
 protected:
@@ -123,6 +142,8 @@ protected:
     
   void add_ptr_objects(
     const namespacet &);
+
+  void number_objects();
 };
 
 bool is_ptr_object(const exprt &);
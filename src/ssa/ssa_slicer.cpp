@@ -0,0 +1,145 @@
+/*******************************************************************\
+
+Module: Cone-of-Influence Slicing of SSA Constraints
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#include <util/find_symbols.h>
+
+#include "ssa_slicer.h"
+
+/*******************************************************************\
+
+Function: ssa_slicert::ssa_slicert
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+ssa_slicert::ssa_slicert(const constraintst &src)
+{
+  constraints.reserve(src.size());
+  symbols.reserve(src.size());
+
+  // how often each symbol is on the left of an equality
+  hash_map_cont<irep_idt, unsigned, irep_id_hash> lhs_count;
+
+  for(constraintst::const_iterator
+      c_it=src.begin();
+      c_it!=src.end();
+      c_it++)
+  {
+    constraints.push_back(&*c_it);
+
+    find_symbols_sett tmp;
+    find_symbols(*c_it, tmp);
+    symbols.push_back(std::vector<irep_idt>(tmp.begin(), tmp.end()));
+
+    if(c_it->id()==ID_equal &&
+       c_it->operands().size()==2 &&
+       c_it->op0().id()==ID_symbol)
+      lhs_count[to_symbol_expr(c_it->op0()).get_identifier()]++;
+  }
+
+  for(unsigned nr=0; nr<constraints.size(); nr++)
+  {
+    const exprt &c=*constraints[nr];
+
+    if(c.id()==ID_equal &&
+       c.operands().size()==2 &&
+       c.op0().id()==ID_symbol)
+    {
+      const irep_idt &lhs=to_symbol_expr(c.op0()).get_identifier();
+
+      // x=e with x in e isn't a definition
+      find_symbols_sett rhs_symbols;
+      find_symbols(c.op1(), rhs_symbols);
+
+      if(lhs_count[lhs]==1 &&
+         rhs_symbols.find(lhs)==rhs_symbols.end())
+      {
+        definitions[lhs]=nr;
+        continue;
+      }
+    }
+
+    others.push_back(nr);
+  }
+}
+
+/*******************************************************************\
+
+Function: ssa_slicert::operator()
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_slicert::operator()(
+  const std::vector<exprt> &seeds,
+  constraintst &dest) const
+{
+  std::vector<bool> in_slice(constraints.size(), false);
+  find_symbols_sett needed;
+  std::vector<irep_idt> queue;
+
+  for(std::vector<exprt>::const_iterator
+      s_it=seeds.begin();
+      s_it!=seeds.end();
+      s_it++)
+  {
+    find_symbols_sett tmp;
+    find_symbols(*s_it, tmp);
+
+    for(find_symbols_sett::const_iterator
+        t_it=tmp.begin(); t_it!=tmp.end(); t_it++)
+      if(needed.insert(*t_it).second)
+        queue.push_back(*t_it);
+  }
+
+  for(std::vector<unsigned>::const_iterator
+      o_it=others.begin();
+      o_it!=others.end();
+      o_it++)
+  {
+    in_slice[*o_it]=true;
+
+    const std::vector<irep_idt> &s=symbols[*o_it];
+    for(unsigned i=0; i<s.size(); i++)
+      if(needed.insert(s[i]).second)
+        queue.push_back(s[i]);
+  }
+
+  // now follow the definitions backwards
+  while(!queue.empty())
+  {
+    irep_idt identifier=queue.back();
+    queue.pop_back();
+
+    definitionst::const_iterator d_it=definitions.find(identifier);
+    if(d_it==definitions.end()) continue; // an input
+
+    unsigned nr=d_it->second;
+    if(in_slice[nr]) continue;
+    in_slice[nr]=true;
+
+    const std::vector<irep_idt> &s=symbols[nr];
+    for(unsigned i=0; i<s.size(); i++)
+      if(needed.insert(s[i]).second)
+        queue.push_back(s[i]);
+  }
+
+  for(unsigned nr=0; nr<constraints.size(); nr++)
+    if(in_slice[nr])
+      dest.push_back(*constraints[nr]);
+}
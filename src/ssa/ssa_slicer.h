@@ -0,0 +1,59 @@
+/*******************************************************************\
+
+Module: Cone-of-Influence Slicing of SSA Constraints
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#ifndef CPROVER_SSA_SLICER_H
+#define CPROVER_SSA_SLICER_H
+
+#include <list>
+#include <vector>
+
+#include <util/std_expr.h>
+#include <util/hash_cont.h>
+
+// Most constraints of the SSA are definitions x=e, for a symbol
+// x that no other constraint defines. Such a definition can be
+// dropped if no constraint we keep mentions x, as x can always
+// be chosen to satisfy it. The other constraints, say assertions
+// of the old version, are always kept. The slice is satisfiable
+// if and only if the constraints we started from are, and the
+// values of the symbols in the slice carry over.
+
+class ssa_slicert
+{
+public:
+  typedef std::list<exprt> constraintst;
+
+  // the constraints must not change while we use them
+  explicit ssa_slicert(const constraintst &);
+
+  // the constraints needed for the symbols in the given
+  // expressions, in the original order
+  void operator()(
+    const std::vector<exprt> &seeds,
+    constraintst &dest) const;
+
+  inline unsigned size() const
+  {
+    return constraints.size();
+  }
+
+protected:
+  std::vector<const exprt *> constraints;
+
+  // the symbols in each constraint
+  std::vector<std::vector<irep_idt> > symbols;
+
+  // the definition of a symbol, by number
+  typedef hash_map_cont<irep_idt, unsigned, irep_id_hash> definitionst;
+  definitionst definitions;
+
+  // the constraints that aren't definitions
+  std::vector<unsigned> others;
+};
+
+#endif
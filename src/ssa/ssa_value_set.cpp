@@ -6,10 +6,13 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <algorithm>
+
 #include <util/pointer_offset_size.h>
 
 #include "ssa_value_set.h"
 #include "ssa_dereference.h"
+#include "module_value_set.h"
 
 /*******************************************************************\
 
@@ -29,11 +32,15 @@ void ssa_value_domaint::transform(
   ai_baset &ai,
   const namespacet &ns)
 {
+  ssa_value_ait &ssa_value_ai=static_cast<ssa_value_ait &>(ai);
+  object_numbering=&ssa_value_ai.object_numbering;
+  ssa_alias_oraclet *alias_oracle=ssa_value_ai.alias_oracle;
+
   if(from->is_assign())
   {
     const code_assignt &assignment=to_code_assign(from->code);
-    exprt lhs_deref=dereference(assignment.lhs(), *this, "", ns);
-    exprt rhs_deref=dereference(assignment.rhs(), *this, "", ns);
+    exprt lhs_deref=dereference(assignment.lhs(), *this, "", ns, alias_oracle);
+    exprt rhs_deref=dereference(assignment.rhs(), *this, "", ns, alias_oracle);
     assign_lhs_rec(lhs_deref, rhs_deref, ns);
   }
   else if(from->is_goto())
@@ -71,7 +78,7 @@ void ssa_value_domaint::transform(
     // the call might come with an assignment
     if(code_function_call.lhs().is_not_nil())
     {
-      exprt lhs_deref=dereference(code_function_call.lhs(), *this, "", ns);
+      exprt lhs_deref=dereference(code_function_call.lhs(), *this, "", ns, alias_oracle);
       assign_lhs_rec(lhs_deref, nil_exprt(), ns);
     }
   }
@@ -298,7 +305,8 @@ void ssa_value_domaint::assign_rhs_rec_address_of(
 
   if(ssa_object)
   {
-    dest.value_set.insert(ssa_object);
+    assert(object_numbering!=NULL);
+    dest.value_set.insert(object_numbering->number(ssa_object));
     if(offset) dest.offset=true;
   }
   else if(rhs.id()==ID_if)
@@ -336,6 +344,7 @@ Function: ssa_value_domaint::valuest::output
 
 void ssa_value_domaint::valuest::output(
   std::ostream &out,
+  const ssa_object_numberingt &object_numbering,
   const namespacet &ns) const
 {
   if(offset)
@@ -348,8 +357,17 @@ void ssa_value_domaint::valuest::output(
   if(unknown) out << " unknown";
   if(integer_address) out << " integer_address";
 
-  for(value_sett::const_iterator it=value_set.begin();
-      it!=value_set.end();
+  std::vector<unsigned> numbers;
+  value_set.get_numbers(numbers);
+
+  std::vector<ssa_objectt> objects;
+  for(unsigned i=0; i<numbers.size(); i++)
+    objects.push_back(object_numbering[numbers[i]]);
+
+  std::sort(objects.begin(), objects.end());
+
+  for(std::vector<ssa_objectt>::const_iterator it=objects.begin();
+      it!=objects.end();
       it++)
     out << ' ' << '&' << it->get_identifier();
 }
@@ -377,7 +395,7 @@ void ssa_value_domaint::output(
       v_it++)
   {
     out << v_it->first.get_identifier() << ':';
-    v_it->second.output(out, ns);
+    v_it->second.output(out, *object_numbering, ns);
     out << '\n';
   }
 }
@@ -405,9 +423,7 @@ bool ssa_value_domaint::valuest::merge(const valuest &src)
   if(src.integer_address && !integer_address) { integer_address=true; result=true; }
 
   // value set
-  unsigned old_size=value_set.size();
-  value_set.insert(src.value_set.begin(), src.value_set.end());
-  if(old_size!=value_set.size()) result=true;
+  if(value_set.merge(src.value_set)) result=true;
   
   // alignment
   alignment=merge_alignment(alignment, src.alignment);
@@ -432,6 +448,9 @@ bool ssa_value_domaint::merge(
   locationt from,
   locationt to)
 {
+  if(object_numbering==NULL)
+    object_numbering=other.object_numbering;
+
   value_mapt::iterator v_it=value_map.begin();
   const value_mapt &new_value_map=other.value_map;
   bool result=false;
@@ -465,3 +484,129 @@ bool ssa_value_domaint::merge(
   
   return result;
 }
+
+/*******************************************************************\
+
+Function: ssa_value_domaint::object_sett::merge
+
+  Inputs:
+
+ Outputs: Return true if "this" has changed.
+
+ Purpose:
+
+\*******************************************************************/
+
+bool ssa_value_domaint::object_sett::merge(const object_sett &src)
+{
+  bool result=false;
+
+  if((first|src.first)!=first)
+  {
+    first|=src.first;
+    result=true;
+  }
+
+  if(src.rest.size()>rest.size())
+  {
+    rest.resize(src.rest.size(), 0);
+    result=true; // the last word of src isn't zero
+  }
+
+  for(unsigned i=0; i<src.rest.size(); i++)
+  {
+    if((rest[i]|src.rest[i])!=rest[i])
+    {
+      rest[i]|=src.rest[i];
+      result=true;
+    }
+  }
+
+  return result;
+}
+
+/*******************************************************************\
+
+Function: ssa_value_domaint::object_sett::get_numbers
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_value_domaint::object_sett::get_numbers(
+  std::vector<unsigned> &dest) const
+{
+  for(unsigned bit=0; bit<WORD_BITS; bit++)
+    if(first&(wordt(1)<<bit))
+      dest.push_back(bit);
+
+  for(unsigned i=0; i<rest.size(); i++)
+  {
+    if(rest[i]==0) continue;
+
+    for(unsigned bit=0; bit<WORD_BITS; bit++)
+      if(rest[i]&(wordt(1)<<bit))
+        dest.push_back((i+1)*WORD_BITS+bit);
+  }
+}
+
+/*******************************************************************\
+
+Function: ssa_value_domaint::get_objects
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_value_domaint::get_objects(
+  const valuest &values,
+  std::vector<ssa_objectt> &dest) const
+{
+  std::vector<unsigned> numbers;
+  values.value_set.get_numbers(numbers);
+
+  if(numbers.empty()) return;
+
+  assert(object_numbering!=NULL);
+
+  for(unsigned i=0; i<numbers.size(); i++)
+    dest.push_back((*object_numbering)[numbers[i]]);
+
+  std::sort(dest.begin(), dest.end());
+}
+
+/*******************************************************************\
+
+Function: ssa_value_ait::initialize
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void ssa_value_ait::initialize(
+  const goto_functionst::goto_functiont &goto_function)
+{
+  ait<ssa_value_domaint>::initialize(goto_function);
+
+  forall_goto_program_instructions(i_it, goto_function.body)
+    operator[](i_it).object_numbering=&object_numbering;
+
+  if(module_value_set!=NULL &&
+     !goto_function.body.instructions.empty())
+  {
+    locationt e=goto_function.body.instructions.begin();
+    module_value_set->seed(goto_function, operator[](e), object_numbering);
+  }
+}
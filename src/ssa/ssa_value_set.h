@@ -9,21 +9,83 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_SSA_VALUE_SET_H
 #define CPROVER_SSA_VALUE_SET_H
 
+#include <vector>
+
+#include <util/numbering.h>
+
 #include <analyses/ai.h>
 
 #include "ssa_object.h"
 
+// The objects that occur in the value sets of a function
+typedef numbering<ssa_objectt> ssa_object_numberingt;
+
+class module_value_sett;
+class ssa_alias_oraclet;
+
 class ssa_value_domaint:public ai_domain_baset
 {
 public:
+  inline ssa_value_domaint():object_numbering(NULL)
+  {
+  }
+
   virtual void transform(locationt, locationt, ai_baset &, const namespacet &);
   virtual void output(std::ostream &, const ai_baset &, const namespacet &) const;
   bool merge(const ssa_value_domaint &, locationt, locationt);
 
+  // Sets of objects, as bit vectors over the numbers of the
+  // objects. Most of these sets are small, and thus, the
+  // first word is kept in place. The last word in 'rest' is
+  // never zero, which makes comparison a matter of comparing
+  // the words.
+  class object_sett
+  {
+  public:
+    typedef unsigned long long wordt;
+    enum { WORD_BITS=64 };
+
+    inline object_sett():first(0)
+    {
+    }
+
+    inline bool empty() const
+    {
+      return first==0 && rest.empty();
+    }
+
+    inline void insert(unsigned nr)
+    {
+      if(nr<WORD_BITS)
+        first|=wordt(1)<<nr;
+      else
+      {
+        unsigned word=nr/WORD_BITS-1;
+        if(word>=rest.size()) rest.resize(word+1, 0);
+        rest[word]|=wordt(1)<<(nr%WORD_BITS);
+      }
+    }
+
+    // returns true if this has changed
+    bool merge(const object_sett &);
+
+    // the numbers of the objects in the set, ascending
+    void get_numbers(std::vector<unsigned> &) const;
+
+    inline bool operator==(const object_sett &other) const
+    {
+      return first==other.first && rest==other.rest;
+    }
+
+  protected:
+    wordt first;
+    std::vector<wordt> rest;
+  };
+
   struct valuest
   {
   public:
-    typedef std::set<ssa_objectt> value_sett;
+    typedef object_sett value_sett;
     value_sett value_set;
     bool offset, null, unknown, integer_address;
     unsigned alignment;
@@ -34,7 +96,10 @@ public:
     {
     }
     
-    void output(std::ostream &, const namespacet &) const;
+    void output(
+      std::ostream &,
+      const ssa_object_numberingt &,
+      const namespacet &) const;
     
     bool merge(const valuest &src);
     
@@ -47,6 +112,15 @@ public:
     {
       return value_set.empty() && !null && !unknown && !integer_address;
     }
+
+    inline bool operator==(const valuest &other) const
+    {
+      return value_set==other.value_set &&
+             offset==other.offset && null==other.null &&
+             unknown==other.unknown &&
+             integer_address==other.integer_address &&
+             alignment==other.alignment;
+    }
   };
   
   // maps objects to values
@@ -59,8 +133,20 @@ public:
     assign_rhs_rec(tmp, src, ns, false, 0);
     return tmp;
   }
+
+  // The objects in a value set, ordered by identifier,
+  // as they would be in a std::set<ssa_objectt>.
+  void get_objects(const valuest &, std::vector<ssa_objectt> &) const;
   
 protected:
+  // shared by all the domains of a function;
+  // owned by the ssa_value_ait
+  ssa_object_numberingt *object_numbering;
+
+  friend class ssa_value_ait;
+  friend class module_value_sett;
+
+
   void assign_lhs_rec(
     const exprt &lhs, const exprt &rhs,
     const namespacet &,
@@ -91,15 +177,30 @@ protected:
 class ssa_value_ait:public ait<ssa_value_domaint>
 {
 public:
+  // The entry state gets the values of the globals and
+  // of the parameters from the module value set, if any.
   ssa_value_ait(
     const goto_functionst::goto_functiont &goto_function,
-    const namespacet &ns)
+    const namespacet &ns,
+    const module_value_sett *_module_value_set=NULL,
+    ssa_alias_oraclet *_alias_oracle=NULL):
+    alias_oracle(_alias_oracle),
+    module_value_set(_module_value_set)
   {
     operator()(goto_function, ns);
   }
 
+  // for dereferencing, optional
+  ssa_alias_oraclet *const alias_oracle;
+
 protected:
   friend class ssa_value_domaint;
+
+  ssa_object_numberingt object_numbering;
+  const module_value_sett *module_value_set;
+
+  // gives all domains the object numbering
+  virtual void initialize(const goto_functionst::goto_functiont &goto_function);
 };
 
 #endif
@@ -0,0 +1,114 @@
+/*******************************************************************\
+
+Module: Weak Topological Order of the Loops of a Function
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#include <algorithm>
+#include <ostream>
+
+#include "wto.h"
+
+/*******************************************************************\
+
+Function: wtot::wtot
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+wtot::wtot(const goto_programt &goto_program)
+{
+  forall_goto_program_instructions(i_it, goto_program)
+  {
+    if(!i_it->is_backwards_goto())
+      continue;
+
+    unsigned nr=components.size();
+    components.push_back(componentt());
+    componentt &component=components.back();
+
+    component.head=i_it->get_target();
+    component.backwards_goto=i_it;
+
+    // The outermost components so far that begin within
+    // this loop are nested in it. They end before it does,
+    // as we go by the backwards gotos.
+    while(!top_level.empty() &&
+          components[top_level.back()].head->location_number>=
+          component.head->location_number)
+    {
+      component.children.push_back(top_level.back());
+      top_level.pop_back();
+    }
+
+    std::reverse(component.children.begin(), component.children.end());
+
+    component.first=component.children.empty()?nr:
+      components[component.children.front()].first;
+
+    top_level.push_back(nr);
+  }
+}
+
+/*******************************************************************\
+
+Function: wtot::output
+
+  Inputs:
+
+ Outputs:
+
+ Purpose:
+
+\*******************************************************************/
+
+void wtot::output(std::ostream &out) const
+{
+  for(std::vector<unsigned>::const_iterator
+      c_it=top_level.begin();
+      c_it!=top_level.end();
+      c_it++)
+  {
+    if(c_it!=top_level.begin()) out << " ";
+    output_rec(*c_it, out);
+  }
+
+  out << "\n";
+}
+
+/*******************************************************************\
+
+Function: wtot::output_rec
+
+  Inputs:
+
+ Outputs:
+
+ Purpose: Bourdoncle's notation: (head inner components)
+
+\*******************************************************************/
+
+void wtot::output_rec(unsigned nr, std::ostream &out) const
+{
+  const componentt &component=components[nr];
+
+  out << "(" << component.head->location_number;
+
+  for(std::vector<unsigned>::const_iterator
+      c_it=component.children.begin();
+      c_it!=component.children.end();
+      c_it++)
+  {
+    out << " ";
+    output_rec(*c_it, out);
+  }
+
+  out << ")";
+}
@@ -0,0 +1,56 @@
+/*******************************************************************\
+
+Module: Weak Topological Order of the Loops of a Function
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+#ifndef CPROVER_WTO_H
+#define CPROVER_WTO_H
+
+#include <iosfwd>
+#include <vector>
+
+#include <goto-programs/goto_program.h>
+
+// The components of Bourdoncle's weak topological order,
+// one per backwards goto. A component is the range from the
+// target of the goto to the goto itself, and the components
+// of the loops within that range are nested in it. Loops
+// that overlap without nesting are siblings.
+
+class wtot
+{
+public:
+  typedef goto_programt::const_targett locationt;
+
+  explicit wtot(const goto_programt &);
+
+  struct componentt
+  {
+    locationt head, backwards_goto;
+
+    // the components directly inside, in program order
+    std::vector<unsigned> children;
+
+    // All components inside have the numbers from 'first'
+    // up to, but excluding, the one of this component.
+    unsigned first;
+  };
+
+  // in program order of the backwards gotos, and thus,
+  // a component comes after the ones nested in it
+  typedef std::vector<componentt> componentst;
+  componentst components;
+
+  // the outermost components, in program order
+  std::vector<unsigned> top_level;
+
+  void output(std::ostream &) const;
+
+protected:
+  void output_rec(unsigned nr, std::ostream &) const;
+};
+
+#endif
@@ -110,6 +110,18 @@ void summary_checkert::check_properties(
 
   const goto_programt &goto_program=f_it->second.body;
 
+  // We give the SSA to the solver only once, and check each
+  // property under an assumption.
+  satcheck_no_simplifiert satcheck;
+  bv_pointerst solver(SSA.ns, satcheck);
+  solver.unbounded_array=bv_pointerst::U_AUTO;
+
+  satcheck.set_message_handler(get_message_handler());
+  solver.set_message_handler(get_message_handler());
+  
+  if(!show_vcc)
+    solver << SSA;
+
   for(goto_programt::instructionst::const_iterator
       i_it=goto_program.instructions.begin();
       i_it!=goto_program.instructions.end();
@@ -127,21 +139,12 @@ void summary_checkert::check_properties(
       continue;
     }
   
-    // solver
-    satcheckt satcheck;
-    bv_pointerst solver(SSA.ns, satcheck);
-    solver.unbounded_array=bv_pointerst::U_AUTO;
-  
-    satcheck.set_message_handler(get_message_handler());
-    solver.set_message_handler(get_message_handler());
-    
-    // give SSA to solver
-    solver << SSA;
-
-    // give negation of property to solver
+    // give negation of property to solver, as assumption
     exprt negated_property=not_exprt(SSA.assertion(i_it));
 
-    solver << negated_property;
+    bvt assumptions;
+    assumptions.push_back(solver.convert(negated_property));
+    satcheck.set_assumptions(assumptions);
     
     property_statust &property_status=property_map[property_id];
     